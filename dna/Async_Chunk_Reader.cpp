@@ -0,0 +1,452 @@
+#include "Async_Chunk_Reader.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <cerrno>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace dna
+{
+    // The bookkeeping shared by both backends: a ring of read slots that are
+    // submitted in file order and retired in file order.
+    class Async_Chunk_Reader::Backend
+    {
+    public:
+        Backend(int fd, size_t begin, size_t end, size_t chunksize, size_t queueDepth) :
+            fd_(fd), end_(end), chunksize_(chunksize), nextOffset_(begin), slots_(queueDepth)
+        {
+            for (auto& slot : slots_)
+                slot.data.resize(chunksize_);
+        }
+
+        virtual ~Backend() = default;
+        virtual bool usingIoUring() const = 0;
+
+        bool next(Chunk& chunk)
+        {
+            fill();
+            if (inFlight_ == 0)
+                return false;
+
+            Slot& slot = slots_[head_];
+            waitFor(head_);
+            if (slot.result < 0)
+                throw std::system_error(static_cast<int>(-slot.result), std::generic_category(), "chunk read failed");
+
+            // A short read is legal, if unusual, for a regular file.  Finish it synchronously.
+            size_t got = static_cast<size_t>(slot.result);
+            while (got < slot.length)
+            {
+                ssize_t n = ::pread(fd_, slot.data.data() + got, slot.length - got, static_cast<off_t>(slot.offset + got));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n < 0)
+                    throw std::system_error(errno, std::generic_category(), "chunk read failed");
+                if (n == 0)
+                    break;
+                got += static_cast<size_t>(n);
+            }
+
+            chunk.offset = slot.offset;
+            std::swap(chunk.data, slot.data);
+            chunk.data.resize(got);
+            slot.data.resize(chunksize_);
+
+            head_ = (head_ + 1) % slots_.size();
+            inFlight_--;
+            fill();
+            return true;
+        }
+
+        void restart(size_t begin)
+        {
+            drain();
+            head_ = 0;
+            inFlight_ = 0;
+            nextOffset_ = begin;
+        }
+
+    protected:
+        struct Slot
+        {
+            size_t offset = 0;
+            size_t length = 0;
+            Chunk_Buffer data;
+            iovec iov{};
+            long result = 0;
+            bool done = false;
+        };
+
+        // Start the read described by slots_[slot].
+        virtual void submit(size_t slot) = 0;
+        // Block until slots_[slot].done.
+        virtual void waitFor(size_t slot) = 0;
+
+        // Wait for every outstanding read so that no buffer is written behind our back.
+        virtual void drain()
+        {
+            for (size_t i = 0; i < inFlight_; i++)
+                waitFor((head_ + i) % slots_.size());
+        }
+
+        void fill()
+        {
+            while (inFlight_ < slots_.size() && nextOffset_ < end_)
+            {
+                size_t index = (head_ + inFlight_) % slots_.size();
+                Slot& slot = slots_[index];
+                slot.offset = nextOffset_;
+                slot.length = std::min(chunksize_, end_ - nextOffset_);
+                slot.result = 0;
+                slot.done = false;
+                slot.iov.iov_base = slot.data.data();
+                slot.iov.iov_len = slot.length;
+                submit(index);
+
+                nextOffset_ += slot.length;
+                inFlight_++;
+            }
+        }
+
+        int fd_;
+        size_t end_;
+        size_t chunksize_;
+        size_t nextOffset_;
+        vector<Slot> slots_;
+        size_t head_ = 0;
+        size_t inFlight_ = 0;
+    };
+
+    namespace
+    {
+        // Blocking preads spread over a set of worker threads.  Used wherever io_uring
+        // is unavailable (old kernels, seccomp sandboxes, containers that disable it).
+        class Thread_Pool_Backend : public Async_Chunk_Reader::Backend
+        {
+            std::mutex mutex_;
+            std::condition_variable work_;
+            std::condition_variable completed_;
+            std::deque<size_t> queue_;
+            vector<std::thread> workers_;
+            bool stopping_ = false;
+
+        public:
+            Thread_Pool_Backend(int fd, size_t begin, size_t end, size_t chunksize, size_t queueDepth) :
+                Backend(fd, begin, end, chunksize, queueDepth)
+            {
+                size_t numWorkers = std::min<size_t>(queueDepth, 64);
+                workers_.reserve(numWorkers);
+                for (size_t i = 0; i < numWorkers; i++)
+                    workers_.emplace_back([this] { run(); });
+            }
+
+            ~Thread_Pool_Backend() override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping_ = true;
+                    queue_.clear();
+                }
+                work_.notify_all();
+                for (auto& worker : workers_)
+                    worker.join();
+            }
+
+            bool usingIoUring() const override
+            {
+                return false;
+            }
+
+        protected:
+            void submit(size_t slot) override
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    queue_.push_back(slot);
+                }
+                work_.notify_one();
+            }
+
+            void waitFor(size_t slot) override
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                completed_.wait(lock, [&] { return slots_[slot].done; });
+            }
+
+            void drain() override
+            {
+                {
+                    // Reads that no worker has picked up yet can simply be forgotten.
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (auto slot : queue_)
+                        slots_[slot].done = true;
+                    queue_.clear();
+                }
+                Backend::drain();
+            }
+
+        private:
+            void run()
+            {
+                while (true)
+                {
+                    size_t index;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex_);
+                        work_.wait(lock, [&] { return stopping_ || !queue_.empty(); });
+                        if (stopping_)
+                            return;
+                        index = queue_.front();
+                        queue_.pop_front();
+                    }
+
+                    Slot& slot = slots_[index];
+                    ssize_t n;
+                    do
+                    {
+                        n = ::pread(fd_, slot.data.data(), slot.length, static_cast<off_t>(slot.offset));
+                    } while (n < 0 && errno == EINTR);
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        slot.result = n < 0 ? -errno : n;
+                        slot.done = true;
+                    }
+                    completed_.notify_all();
+                }
+            }
+        };
+
+        // A minimal io_uring driver on top of the raw system calls, so that we don't
+        // need liburing at build time.  One submission queue entry per slot, and the
+        // slot index rides along as the user data.
+        class Io_Uring_Backend : public Async_Chunk_Reader::Backend
+        {
+            int ringFd_ = -1;
+            void* sqRing_ = MAP_FAILED;
+            void* cqRing_ = MAP_FAILED;
+            size_t sqRingSize_ = 0;
+            size_t cqRingSize_ = 0;
+            io_uring_sqe* sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+            size_t sqesSize_ = 0;
+
+            unsigned* sqHead_ = nullptr;
+            unsigned* sqTail_ = nullptr;
+            unsigned* sqMask_ = nullptr;
+            unsigned* sqArray_ = nullptr;
+            unsigned* cqHead_ = nullptr;
+            unsigned* cqTail_ = nullptr;
+            unsigned* cqMask_ = nullptr;
+            io_uring_cqe* cqes_ = nullptr;
+
+        public:
+            Io_Uring_Backend(int fd, size_t begin, size_t end, size_t chunksize, size_t queueDepth) :
+                Backend(fd, begin, end, chunksize, queueDepth)
+            {
+                io_uring_params params;
+                std::memset(&params, 0, sizeof(params));
+                ringFd_ = static_cast<int>(::syscall(SYS_io_uring_setup, static_cast<unsigned>(queueDepth), &params));
+                if (ringFd_ < 0)
+                    throw std::system_error(errno, std::generic_category(), "io_uring_setup failed");
+
+                sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (singleMap)
+                    sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+                sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+                if (sqRing_ == MAP_FAILED)
+                    fail("mapping the submission ring failed");
+
+                if (singleMap)
+                {
+                    cqRing_ = sqRing_;
+                }
+                else
+                {
+                    cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+                    if (cqRing_ == MAP_FAILED)
+                        fail("mapping the completion ring failed");
+                }
+
+                sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+                sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+                if (sqes_ == MAP_FAILED)
+                    fail("mapping the submission entries failed");
+
+                auto sq = static_cast<char*>(sqRing_);
+                auto cq = static_cast<char*>(cqRing_);
+                sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+                sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            }
+
+            ~Io_Uring_Backend() override
+            {
+                try
+                {
+                    drain();
+                }
+                catch (...)
+                {
+                }
+                release();
+            }
+
+            bool usingIoUring() const override
+            {
+                return true;
+            }
+
+        protected:
+            void submit(size_t slot) override
+            {
+                unsigned tail = *sqTail_;
+                unsigned index = tail & *sqMask_;
+                io_uring_sqe* sqe = &sqes_[index];
+                std::memset(sqe, 0, sizeof(*sqe));
+                sqe->opcode = IORING_OP_READV;
+                sqe->fd = fd_;
+                sqe->addr = reinterpret_cast<unsigned long long>(&slots_[slot].iov);
+                sqe->len = 1;
+                sqe->off = slots_[slot].offset;
+                sqe->user_data = slot;
+                sqArray_[index] = index;
+
+                // The kernel only reads the submission ring inside io_uring_enter, so the
+                // tail has to be published first.  A full completion ring is made room in
+                // and the entry tried again.
+                __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+                int submitted;
+                while ((submitted = enter(1, 0, 0)) < 0 && (errno == EINTR || errno == EBUSY))
+                {
+                    if (errno == EBUSY)
+                        reap();
+                }
+                if (submitted == 1)
+                    return;
+
+                // Once the kernel has taken the entry, its completion will come, so the read
+                // is in flight whatever io_uring_enter said.  Otherwise take the entry back,
+                // so that no later submission carries it along with a slot that isn't
+                // waiting for it.
+                int error = submitted < 0 ? errno : EAGAIN;
+                if (__atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) != tail)
+                    return;
+                __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+                throw std::system_error(error, std::generic_category(), "io_uring_enter failed");
+            }
+
+            void waitFor(size_t slot) override
+            {
+                while (true)
+                {
+                    reap();
+                    if (slots_[slot].done)
+                        return;
+                    if (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR)
+                        throw std::system_error(errno, std::generic_category(), "io_uring_enter failed");
+                }
+            }
+
+        private:
+            int enter(unsigned toSubmit, unsigned minComplete, unsigned flags)
+            {
+                return static_cast<int>(::syscall(SYS_io_uring_enter, ringFd_, toSubmit, minComplete, flags, nullptr, 0));
+            }
+
+            void reap()
+            {
+                unsigned head = *cqHead_;
+                while (head != __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE))
+                {
+                    const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+                    Slot& slot = slots_[static_cast<size_t>(cqe.user_data)];
+                    slot.result = cqe.res;
+                    slot.done = true;
+                    head++;
+                }
+                __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+            }
+
+            [[noreturn]] void fail(const char* what)
+            {
+                int error = errno;
+                release();
+                throw std::system_error(error, std::generic_category(), what);
+            }
+
+            void release()
+            {
+                if (sqes_ != MAP_FAILED)
+                    ::munmap(sqes_, sqesSize_);
+                if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_)
+                    ::munmap(cqRing_, cqRingSize_);
+                if (sqRing_ != MAP_FAILED)
+                    ::munmap(sqRing_, sqRingSize_);
+                if (ringFd_ >= 0)
+                    ::close(ringFd_);
+                sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+                cqRing_ = sqRing_ = MAP_FAILED;
+                ringFd_ = -1;
+            }
+        };
+    }
+
+    Async_Chunk_Reader::Async_Chunk_Reader(int fd, size_t begin, size_t end, size_t chunksize,
+                                           size_t queueDepth, Async_Backend backend)
+    {
+        if (chunksize == 0 || queueDepth == 0)
+            throw std::invalid_argument("chunk size and queue depth must be positive");
+
+        if (backend != Async_Backend::thread_pool)
+        {
+            try
+            {
+                backend_ = std::make_unique<Io_Uring_Backend>(fd, begin, end, chunksize, queueDepth);
+            }
+            catch (const std::system_error&)
+            {
+                if (backend == Async_Backend::io_uring)
+                    throw;
+            }
+        }
+
+        if (!backend_)
+            backend_ = std::make_unique<Thread_Pool_Backend>(fd, begin, end, chunksize, queueDepth);
+    }
+
+    Async_Chunk_Reader::~Async_Chunk_Reader() = default;
+
+    bool Async_Chunk_Reader::next(Chunk& chunk)
+    {
+        return backend_->next(chunk);
+    }
+
+    void Async_Chunk_Reader::restart(size_t begin)
+    {
+        backend_->restart(begin);
+    }
+
+    bool Async_Chunk_Reader::usingIoUring() const
+    {
+        return backend_->usingIoUring();
+    }
+}
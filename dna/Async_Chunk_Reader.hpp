@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Genome_Buffer.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    enum class Async_Backend
+    {
+        automatic,      // io_uring when the kernel allows it, otherwise a thread pool
+        io_uring,
+        thread_pool
+    };
+
+    // Keeps a queue of in-flight reads against a file descriptor and hands the
+    // completed chunks back in file order.  A single sequential pread() only ever
+    // has one request outstanding, which leaves most of an NVMe device idle when
+    // the data isn't already in the page cache.
+    class Async_Chunk_Reader
+    {
+    public:
+        // Cache line aligned, like the in-memory genome buffers.
+        using Chunk_Buffer = vector<std::byte, aligned_allocator<std::byte>>;
+
+        struct Chunk
+        {
+            size_t offset = 0;
+            Chunk_Buffer data;
+        };
+
+        class Backend;
+
+        Async_Chunk_Reader(int fd, size_t begin, size_t end, size_t chunksize,
+                           size_t queueDepth = 8, Async_Backend backend = Async_Backend::automatic);
+        ~Async_Chunk_Reader();
+
+        Async_Chunk_Reader(const Async_Chunk_Reader&) = delete;
+        Async_Chunk_Reader& operator=(const Async_Chunk_Reader&) = delete;
+
+        // Block until the next chunk in file order has completed and move it into chunk.
+        // The previous contents of chunk are recycled as a read buffer.
+        // Returns false once the end of the range has been delivered.
+        bool next(Chunk& chunk);
+
+        // Drop everything that is in flight and start reading again from the given offset.
+        void restart(size_t begin);
+
+        bool usingIoUring() const;
+
+    private:
+        std::unique_ptr<Backend> backend_;
+    };
+}
@@ -0,0 +1,185 @@
+#include "Base_Encoder.hpp"
+#include "base.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DNA_HAVE_AVX2_ENCODER 1
+#endif
+
+namespace dna
+{
+    // The 2-bit code of every character, to_base() as a table.
+    static constexpr std::array<std::uint8_t, 256> CODES = [] {
+        std::array<std::uint8_t, 256> codes{};
+        for (int c = 0; c < 256; c++)
+            codes[c] = static_cast<std::uint8_t>(to_base(static_cast<char>(c)));
+        return codes;
+    }();
+
+    static void encodeScalar(const char* text, size_t quads, std::byte* out)
+    {
+        auto code = [&](size_t i) { return CODES[static_cast<unsigned char>(text[i])]; };
+        for (size_t q = 0; q < quads; q++, text += packed_size::value)
+            out[q] = static_cast<std::byte>((code(0) << 6) | (code(1) << 4) | (code(2) << 2) | code(3));
+    }
+
+#ifdef DNA_HAVE_AVX2_ENCODER
+    // 32 characters to 8 bytes at a time: compare against 'C', 'G' and 'T' to get the
+    // codes, then fold neighbouring codes together with multiply-adds, 2 bits and 2 bits
+    // into 4, then 4 and 4 into 8, and gather the low byte of every 32-bit lane.
+    __attribute__((target("avx2")))
+    static void encodeAvx2(const char* text, size_t quads, std::byte* out)
+    {
+        const __m256i c = _mm256_set1_epi8('C');
+        const __m256i g = _mm256_set1_epi8('G');
+        const __m256i t = _mm256_set1_epi8('T');
+        const __m256i one = _mm256_set1_epi8(1);
+        const __m256i two = _mm256_set1_epi8(2);
+        const __m256i pairs = _mm256_set1_epi16(0x0104);        // first * 4 + second
+        const __m256i quadsOf = _mm256_set1_epi32(0x00010010);  // first pair * 16 + second
+        const __m256i lowBytes = _mm256_setr_epi8(
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+        size_t q = 0;
+        for (; q + 8 <= quads; q += 8, text += 32, out += 8)
+        {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text));
+            __m256i isC = _mm256_cmpeq_epi8(chars, c);
+            __m256i isG = _mm256_cmpeq_epi8(chars, g);
+            __m256i isT = _mm256_cmpeq_epi8(chars, t);
+            __m256i codes = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(isC, isT), one),
+                                            _mm256_and_si256(_mm256_or_si256(isG, isT), two));
+
+            __m256i nibbles = _mm256_maddubs_epi16(codes, pairs);
+            __m256i bytes = _mm256_madd_epi16(nibbles, quadsOf);
+            __m256i packed = _mm256_shuffle_epi8(bytes, lowBytes);
+
+            std::uint32_t low = static_cast<std::uint32_t>(_mm256_cvtsi256_si32(packed));
+            std::uint32_t high = static_cast<std::uint32_t>(_mm256_extract_epi32(packed, 4));
+            std::memcpy(out, &low, 4);
+            std::memcpy(out + 4, &high, 4);
+        }
+        encodeScalar(text, quads - q, out);
+    }
+#endif
+
+    // Whole groups of four characters, as fast as the processor allows.
+    static void encodeQuads(const char* text, size_t quads, std::byte* out)
+    {
+#ifdef DNA_HAVE_AVX2_ENCODER
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx2)
+        {
+            encodeAvx2(text, quads, out);
+            return;
+        }
+#endif
+        encodeScalar(text, quads, out);
+    }
+
+    size_t EncodeBases(std::string_view text, std::byte* out)
+    {
+        size_t quads = text.size() / packed_size::value;
+        encodeQuads(text.data(), quads, out);
+
+        size_t rest = text.size() - quads * packed_size::value;
+        if (rest == 0)
+            return quads;
+
+        char last[4] = { 'A', 'A', 'A', 'A' };
+        std::memcpy(last, text.data() + quads * packed_size::value, rest);
+        encodeScalar(last, 1, out + quads);
+        return quads + 1;
+    }
+
+    vector<std::byte> EncodeBases(std::string_view text)
+    {
+        vector<std::byte> data((text.size() + packed_size::value - 1) / packed_size::value);
+        EncodeBases(text, data.data());
+        return data;
+    }
+
+    size_t Base_Encoder::MaximumBytes(size_t textLength)
+    {
+        return (textLength + 3) / packed_size::value;
+    }
+
+    size_t Base_Encoder::encode(std::string_view text, std::byte* out)
+    {
+        bases_ += text.size();
+        size_t written = 0;
+
+        // Complete the byte held over from last time.
+        if (heldCount_ > 0)
+        {
+            size_t take = std::min(packed_size::value - heldCount_, text.size());
+            std::memcpy(held_ + heldCount_, text.data(), take);
+            heldCount_ += take;
+            text.remove_prefix(take);
+            if (heldCount_ < packed_size::value)
+                return 0;
+
+            encodeScalar(held_, 1, out);
+            heldCount_ = 0;
+            written = 1;
+        }
+
+        size_t quads = text.size() / packed_size::value;
+        encodeQuads(text.data(), quads, out + written);
+        written += quads;
+
+        heldCount_ = text.size() - quads * packed_size::value;
+        std::memcpy(held_, text.data() + quads * packed_size::value, heldCount_);
+        return written;
+    }
+
+    size_t Base_Encoder::finish(std::byte* out)
+    {
+        if (heldCount_ == 0)
+            return 0;
+
+        char last[4] = { 'A', 'A', 'A', 'A' };
+        std::memcpy(last, held_, heldCount_);
+        encodeScalar(last, 1, out);
+        heldCount_ = 0;
+        return 1;
+    }
+
+    size_t Base_Encoder::bases() const
+    {
+        return bases_;
+    }
+
+    // Big enough to stream at disk speed, small enough to stay in cache.
+    static const size_t STREAM_BLOCK_SIZE = 1 << 20;
+
+    size_t EncodeStream(std::istream& text, std::ostream& packed)
+    {
+        Base_Encoder encoder;
+        vector<char> in(STREAM_BLOCK_SIZE);
+        vector<std::byte> out(Base_Encoder::MaximumBytes(in.size()));
+
+        while (text)
+        {
+            text.read(in.data(), static_cast<std::streamsize>(in.size()));
+            size_t got = static_cast<size_t>(text.gcount());
+            if (got == 0)
+                break;
+
+            size_t bytes = encoder.encode(std::string_view(in.data(), got), out.data());
+            packed.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(bytes));
+        }
+
+        size_t bytes = encoder.finish(out.data());
+        packed.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(bytes));
+        if (!packed)
+            throw std::ios_base::failure("unable to write the packed bases");
+        return encoder.bases();
+    }
+}
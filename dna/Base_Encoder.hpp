@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+using std::vector;
+
+namespace dna
+{
+    // Pack text bases into the 2-bit format, four to a byte with the first base in the
+    // top bits, exactly as pack() and to_base() would: 'C', 'G' and 'T' are themselves
+    // and every other character is an 'A'.  Writes (text.size() + 3) / 4 bytes, the last
+    // padded with 'A'.  Uses AVX2 where the processor has it.
+    size_t EncodeBases(std::string_view text, std::byte* out);
+    vector<std::byte> EncodeBases(std::string_view text);
+
+    // The same, for text that arrives in pieces of any length.  Up to three bases are
+    // held over between pieces to complete a byte.
+    class Base_Encoder
+    {
+    public:
+        // Bytes encode() can write for a piece of the given length.
+        static size_t MaximumBytes(size_t textLength);
+
+        // Returns the number of bytes written.
+        size_t encode(std::string_view text, std::byte* out);
+
+        // Write out the held-over bases, padded.  Returns the bytes written, zero or one.
+        size_t finish(std::byte* out);
+
+        size_t bases() const;
+
+    private:
+        char held_[3] = {};
+        size_t heldCount_ = 0;
+        size_t bases_ = 0;
+    };
+
+    // Encode a text stream of any size into a packed one, a block at a time.  Returns
+    // the number of bases.
+    size_t EncodeStream(std::istream& text, std::ostream& packed);
+}
@@ -0,0 +1,111 @@
+#include "Bit_Planes.hpp"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+namespace dna
+{
+    // A packed byte's four bases as the high bits in the top nibble and the low bits in
+    // the bottom one, the first base in bit 0 of each; and back again.
+    static constexpr std::array<std::uint8_t, 256> SPLIT = [] {
+        std::array<std::uint8_t, 256> table{};
+        for (unsigned byte = 0; byte < table.size(); byte++)
+        {
+            unsigned high = 0, low = 0;
+            for (unsigned k = 0; k < packed_size::value; k++)
+            {
+                unsigned value = (byte >> (6 - 2 * k)) & 3;
+                high |= (value >> 1) << k;
+                low |= (value & 1) << k;
+            }
+            table[byte] = static_cast<std::uint8_t>((high << 4) | low);
+        }
+        return table;
+    }();
+
+    static constexpr std::array<std::uint8_t, 256> JOIN = [] {
+        std::array<std::uint8_t, 256> table{};
+        for (unsigned byte = 0; byte < table.size(); byte++)
+            table[SPLIT[byte]] = static_cast<std::uint8_t>(byte);
+        return table;
+    }();
+
+    Bit_Planes::Bit_Planes(const sequence_buffer<byte_view>& packed) :
+        high_((packed.size() + WORD_BASES - 1) / WORD_BASES),
+        low_(high_.size()),
+        size_(packed.size())
+    {
+        // word() takes care of the phase and reads past the end as adenine, which is
+        // clear in both planes.
+        const size_t wordBases = sequence_buffer<byte_view>::word_bases;
+        for (size_t i = 0; i < size_; i += wordBases)
+        {
+            std::uint64_t bases = packed.word(i);
+            std::uint64_t high = 0, low = 0;
+            for (size_t b = 0; b < sizeof(bases); b++)
+            {
+                unsigned split = SPLIT[(bases >> (56 - 8 * b)) & 0xFF];
+                high |= std::uint64_t(split >> 4) << (4 * b);
+                low |= std::uint64_t(split & 0x0F) << (4 * b);
+            }
+            high_[i / WORD_BASES] |= high << (i % WORD_BASES);
+            low_[i / WORD_BASES] |= low << (i % WORD_BASES);
+        }
+    }
+
+    vector<std::byte> Bit_Planes::packed() const
+    {
+        vector<std::byte> result((size_ + packed_size::value - 1) / packed_size::value);
+        const size_t bytesPerWord = WORD_BASES / packed_size::value;
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            size_t shift = packed_size::value * (i % bytesPerWord);
+            unsigned high = (high_[i / bytesPerWord] >> shift) & 0x0F;
+            unsigned low = (low_[i / bytesPerWord] >> shift) & 0x0F;
+            result[i] = static_cast<std::byte>(JOIN[(high << 4) | low]);
+        }
+        return result;
+    }
+
+    base Bit_Planes::at(size_t index) const
+    {
+        unsigned high = (high_[index / WORD_BASES] >> (index % WORD_BASES)) & 1;
+        unsigned low = (low_[index / WORD_BASES] >> (index % WORD_BASES)) & 1;
+        return static_cast<base>((high << 1) | low);
+    }
+
+    vector<std::uint64_t> Bit_Planes::matches(base value) const
+    {
+        vector<std::uint64_t> result(words());
+        for (size_t word = 0; word < result.size(); word++)
+            result[word] = matchesAt(value, word);
+        return result;
+    }
+
+    static void requireSameSize(const Bit_Planes& a, const Bit_Planes& b)
+    {
+        if (a.size() != b.size())
+            throw std::invalid_argument("sequences must be the same length to count mismatches");
+    }
+
+    vector<std::uint64_t> MismatchMask(const Bit_Planes& a, const Bit_Planes& b)
+    {
+        requireSameSize(a, b);
+
+        vector<std::uint64_t> result(a.words());
+        for (size_t word = 0; word < result.size(); word++)
+            result[word] = (a.high()[word] ^ b.high()[word]) | (a.low()[word] ^ b.low()[word]);
+        return result;
+    }
+
+    size_t CountMismatches(const Bit_Planes& a, const Bit_Planes& b)
+    {
+        requireSameSize(a, b);
+
+        size_t count = 0;
+        for (size_t word = 0; word < a.words(); word++)
+            count += std::popcount((a.high()[word] ^ b.high()[word]) | (a.low()[word] ^ b.low()[word]));
+        return count;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "byte_view.hpp"
+#include "sequence_buffer.hpp"
+#include "motif.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // A sequence stored as two bitplanes, one for the high bit of every base and one for
+    // the low, with base i in bit i % 64 of word i / 64.  Telling bases apart is then
+    // AND, OR and XOR on whole words, with none of the shifting and masking that pairs
+    // of bits need, and loops over the planes vectorize to 512 bases an instruction
+    // where the processor has AVX-512.  Bits past the last base are always clear.
+    class Bit_Planes
+    {
+    public:
+        static constexpr size_t WORD_BASES = 64;
+
+        Bit_Planes() = default;
+
+        // Split packed bases, at any phase, into planes.
+        explicit Bit_Planes(const sequence_buffer<byte_view>& packed);
+
+        // Back to pack()'s layout: (size() + 3) / 4 bytes, the last padded with 'A'.
+        vector<std::byte> packed() const;
+
+        size_t size() const { return size_; }
+        size_t words() const { return high_.size(); }
+        base at(size_t index) const;
+
+        const vector<std::uint64_t>& high() const { return high_; }
+        const vector<std::uint64_t>& low() const { return low_; }
+
+        // Bit i set where base i is the given one.
+        vector<std::uint64_t> matches(base value) const;
+
+        // Word `word` of that plane, starting `shift` bases in, for kernels that combine
+        // several planes without storing them.
+        std::uint64_t matches(base value, size_t word, size_t shift = 0) const
+        {
+            std::uint64_t result = matchesAt(value, word) >> shift;
+            if (shift > 0)
+                result |= matchesAt(value, word + 1) << (WORD_BASES - shift);
+            return result;
+        }
+
+        bool operator==(const Bit_Planes& other) const = default;
+
+    private:
+        std::uint64_t matchesAt(base value, size_t word) const
+        {
+            if (word >= high_.size())
+                return 0;
+
+            // Flip the bits the base has clear, so that only its positions are all ones.
+            std::uint64_t high = static_cast<unsigned>(value) & 2 ? high_[word] : ~high_[word];
+            std::uint64_t low = static_cast<unsigned>(value) & 1 ? low_[word] : ~low_[word];
+            return high & low & valid(word);
+        }
+
+        std::uint64_t valid(size_t word) const
+        {
+            size_t remaining = size_ - word * WORD_BASES;
+            return remaining >= WORD_BASES ? ~std::uint64_t(0) : (std::uint64_t(1) << remaining) - 1;
+        }
+
+        vector<std::uint64_t> high_;
+        vector<std::uint64_t> low_;
+        size_t size_ = 0;
+    };
+
+    // Bit i set where the two sequences, which must be the same length, differ.
+    vector<std::uint64_t> MismatchMask(const Bit_Planes& a, const Bit_Planes& b);
+
+    // How many bases differ between two sequences of the same length.
+    size_t CountMismatches(const Bit_Planes& a, const Bit_Planes& b);
+
+    // Bit i set where a copy of the motif starts at base i.  Each base of the motif is
+    // one AND with its plane shifted down, unrolled at compile time.
+    template<motif_string Text>
+    vector<std::uint64_t> FindMotif(const Bit_Planes& planes)
+    {
+        using pattern = motif<Text>;
+
+        vector<std::uint64_t> result(planes.words());
+        for (size_t word = 0; word < result.size(); word++)
+        {
+            result[word] = [&]<size_t... I>(std::index_sequence<I...>) {
+                return (planes.matches(to_base(pattern::text[I]), word, I) & ...);
+            }(std::make_index_sequence<pattern::size>{});
+        }
+        return result;
+    }
+}
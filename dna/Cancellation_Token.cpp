@@ -0,0 +1,39 @@
+#include "Cancellation_Token.hpp"
+
+namespace dna
+{
+    Cancellation_Token::Cancellation_Token(Clock::time_point deadline)
+    {
+        setDeadline(deadline);
+    }
+
+    Cancellation_Token Cancellation_Token::After(Clock::duration timeout)
+    {
+        return Cancellation_Token(Clock::now() + timeout);
+    }
+
+    void Cancellation_Token::cancel()
+    {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    void Cancellation_Token::setDeadline(Clock::time_point deadline)
+    {
+        deadline_.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    }
+
+    bool Cancellation_Token::cancelled() const
+    {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    bool Cancellation_Token::expired() const
+    {
+        return Clock::now().time_since_epoch().count() >= deadline_.load(std::memory_order_relaxed);
+    }
+
+    bool Cancellation_Token::stopRequested() const
+    {
+        return cancelled() || expired();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace dna
+{
+    // Lets whoever started a comparison stop it: by cancelling it outright, or by giving
+    // it a deadline.  Comparers check the token once per chunk, so a stopped comparison
+    // wastes at most one chunk's work.  Safe to share between threads.
+    class Cancellation_Token
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Cancellation_Token() = default;
+        explicit Cancellation_Token(Clock::time_point deadline);
+
+        Cancellation_Token(const Cancellation_Token&) = delete;
+        Cancellation_Token& operator=(const Cancellation_Token&) = delete;
+
+        // A token whose deadline is the given time from now.
+        static Cancellation_Token After(Clock::duration timeout);
+
+        void cancel();
+        void setDeadline(Clock::time_point deadline);
+
+        bool cancelled() const;
+        bool expired() const;
+
+        // Either of the above.
+        bool stopRequested() const;
+
+    private:
+        std::atomic<bool> cancelled_{false};
+        std::atomic<Clock::rep> deadline_{Clock::time_point::max().time_since_epoch().count()};
+    };
+}
@@ -1,129 +1,453 @@
 #include "Chromosome_Comparer.hpp"
 #include "sequence_buffer.hpp"
+#include "motif.hpp"
 #include "base.hpp"
 #include "String_Comparer.hpp"
+#include "Reverse_Complement.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
-#include <sstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 using std::vector;
-using std::ostringstream;
 
 namespace dna
 {
-    static string TELOMERE = "TTAGGG";
-    static vector<string> LEADING_TELOMERE_FRAGMENTS{ "TAGGG", "AGGG", "GGG", "GG", "G" };
-    static vector<string> TAILING_TELOMERE_FRAGMENTS{ "TTAGG", "TTAG", "TTA", "TT", "T" };
+    using telomere = motif<"TTAGGG">;
 
-    Chromosome_Comparer::Chromosome_Comparer(int number, DNA_Stream& c1, DNA_Stream& c2) :
-        num_(number), c1_(c1), c2_(c2)
+    template<typename Stream>
+    static std::shared_ptr<Stream> OppositeStrand(Stream& stream, const Comparison_Options& options)
     {
+        if (!options.oppositeStrand)
+            return nullptr;
+
+        if constexpr (std::is_same_v<Stream, DNA_Stream>)
+            return std::make_shared<DNA_Stream>(ReverseComplement(stream, options.oppositePadding));
+        else
+            throw std::invalid_argument("only in-memory chromosomes can be compared against the opposite strand");
     }
 
-    Chromosome_Comparison Chromosome_Comparer::Compare()
+    template<typename Stream>
+    Basic_Chromosome_Comparer<Stream>::Basic_Chromosome_Comparer(int number, Stream& c1, Stream& c2,
+                                                                 const Comparison_Options& options) :
+        num_(number), opposite_(OppositeStrand(c2, options)), c1_(c1),
+        c2_(opposite_ != nullptr ? *opposite_ : c2), options_(options)
     {
-        Chromosome_Comparison comparison;
-        comparison.chromosome = num_;
+    }
+
+    template<typename Stream>
+    Chromosome_Comparison Basic_Chromosome_Comparer<Stream>::Compare()
+    {
+        Prepare();
+
+        // The whole chromosome as one segment, read straight from our own streams.
+        vector<Comparison_Segment> segments(1);
+        compareChunks(c1_, c2_, segments[0]);
+        return finish(segments, false);
+    }
+
+    template<typename Stream>
+    Chromosome_Comparison Basic_Chromosome_Comparer<Stream>::Resume(const Chromosome_Comparison& partial)
+    {
+        if (partial.complete)
+            return partial;
+
+        Prepare();
+
+        // What was found so far, as though it were an earlier segment, then the rest.
+        vector<Comparison_Segment> segments(2);
+        segments[0].end = partial.resumeFrom;
+        segments[0].transformations = partial.packedTransformations.empty() ? partial.transformations
+                                                                            : partial.packedTransformations.unpack();
+        segments[1].begin = partial.resumeFrom;
+        segments[1].c2Begin = partial.resumeFromOnC2;
+        c1_.seek(c1Start_ + partial.resumeFrom);
+        c2_.seek(c2Start_ + partial.resumeFromOnC2);
+        compareChunks(c1_, c2_, segments[1]);
+        return finish(segments, false);
+    }
+
+    template<typename Stream>
+    void Basic_Chromosome_Comparer<Stream>::Prepare()
+    {
+        trailingNonTelomereCharsOnC1_ = initializeStream(c1_, c1Start_, true);
+        trailingNonTelomereCharsOnC2_ = initializeStream(c2_, c2Start_, false);
+    }
+
+    template<typename Stream>
+    size_t Basic_Chromosome_Comparer<Stream>::c1Start() const
+    {
+        return c1Start_ * packed_size::value + trailingNonTelomereCharsOnC1_;
+    }
+
+    template<typename Stream>
+    size_t Basic_Chromosome_Comparer<Stream>::c2Start() const
+    {
+        return c2Start_ * packed_size::value + trailingNonTelomereCharsOnC2_;
+    }
+
+    template<typename Stream>
+    vector<Comparison_Segment> Basic_Chromosome_Comparer<Stream>::Split(size_t segmentBytes) const
+    {
+        size_t remaining = std::max(c1_.size() - c1Start_, c2_.size() - c2Start_);
+
+        // With fixed chunking a segment must start where Compare() would start a chunk,
+        // which it can only do when both streams use the same chunk size.
+        if (!options_.adaptiveChunking)
+        {
+            size_t chunksize = c1_.chunkSize();
+            if (chunksize != c2_.chunkSize())
+                segmentBytes = remaining;
+            else
+                segmentBytes = (segmentBytes + chunksize - 1) / chunksize * chunksize;
+        }
+        segmentBytes = std::max<size_t>(segmentBytes, 1);
+
+        vector<Comparison_Segment> segments;
+        for (size_t begin = 0; begin < remaining; begin += segmentBytes)
+        {
+            segments.emplace_back();
+            segments.back().begin = begin;
+            segments.back().end = begin + segmentBytes;
+            segments.back().c2Begin = begin;
+        }
+
+        // The last segment runs to wherever the chromosomes turn out to end.
+        if (segments.empty())
+            segments.emplace_back();
+        segments.back().end = static_cast<size_t>(-1);
+        return segments;
+    }
+
+    template<typename Stream>
+    void Basic_Chromosome_Comparer<Stream>::CompareSegment(Comparison_Segment& segment) const
+        requires std::copy_constructible<Stream>
+    {
+        // Private cursors, so that any number of segments can be compared at once.
+        Stream c1(c1_);
+        Stream c2(c2_);
+        c1.seek(c1Start_ + segment.begin);
+        c2.seek(c2Start_ + segment.c2Begin);
+        compareChunks(c1, c2, segment);
+    }
+
+    template<typename Stream>
+    Chromosome_Comparison Basic_Chromosome_Comparer<Stream>::Finish(vector<Comparison_Segment>& segments)
+    {
+        return finish(segments, true);
+    }
+
+    template<typename Stream>
+    Chromosome_Comparison Basic_Chromosome_Comparer<Stream>::Compare(Work_Stealing_Pool& pool, size_t segmentBytes)
+        requires std::copy_constructible<Stream>
+    {
+        Prepare();
+        vector<Comparison_Segment> segments = Split(segmentBytes);
 
-        vector<Transformation> transforms;
+        Task_Group group(pool);
+        for (auto& segment : segments)
+            group.run([this, &segment] { CompareSegment(segment); });
+        group.wait();
 
-        trailingNonTelomereCharsOnC1_ = initializeStream(c1_, true);
-        trailingNonTelomereCharsOnC2_ = initializeStream(c2_, false);
+        return Finish(segments);
+    }
 
-        size_t c1BytesSoFar = bytesReadFromC1_;
+    template<typename Stream>
+    void Basic_Chromosome_Comparer<Stream>::compareChunks(Stream& c1, Stream& c2, Comparison_Segment& segment) const
+    {
+        // Only the first segment starts in the byte holding the end of the last leading
+        // telomere, so only it has telomere characters to skip.
+        int trailingOnC1 = segment.begin == 0 ? trailingNonTelomereCharsOnC1_ : 0;
+        int trailingOnC2 = segment.c2Begin == 0 ? trailingNonTelomereCharsOnC2_ : 0;
+        size_t limit = segment.end - segment.begin;
+
+        // Everything before this segment already reads like c2, after c1's own leading
+        // telomeres, so that is where its transformations start.
+        size_t indexSoFar = bytesReadFromC1_;
+        if (segment.c2Begin > 0)
+            indexSoFar += segment.c2Begin * packed_size::value - trailingNonTelomereCharsOnC2_;
+
+        segment.transformations.clear();
+        segment.c1Bytes = 0;
+        segment.c2Bytes = 0;
+        segment.stopped = false;
+        segment.memory = options_.memory != nullptr ? Memory_Reservation(*options_.memory) : Memory_Reservation();
+
+        Chunk_Size_Controller chunkSizes(options_.chunkLimits);
 
         // Iterate through the chunks from each of the chromosomes.
-        while (!c1_.atEnd() && !c2_.atEnd())
+        while (!c1.atEnd() && !c2.atEnd() && segment.c1Bytes < limit)
         {
-            string c1String = getNextChunkOfChars(c1_, trailingNonTelomereCharsOnC1_);
-            string c2String = getNextChunkOfChars(c2_, trailingNonTelomereCharsOnC2_);
+            if (options_.cancellation != nullptr && options_.cancellation->stopRequested())
+            {
+                segment.stopped = true;
+                break;
+            }
+
+            // A chunk size of zero means the streams' own chunk size.
+            size_t chunkBytes = options_.adaptiveChunking ? std::min(chunkSizes.next(), limit - segment.c1Bytes) : 0;
+
+            // Hold the DP table and both unpacked chunks against the budget before reading.
+            // Only this segment can give back what its transformations are charged, so
+            // under the wait policy they stop counting before it waits; otherwise it would
+            // wait on itself.
+            Memory_Reservation workspace;
+            if (options_.memory != nullptr)
+            {
+                size_t c1Chars = (chunkBytes > 0 ? chunkBytes : c1.chunkSize()) * packed_size::value;
+                size_t c2Chars = (chunkBytes > 0 ? chunkBytes : c2.chunkSize()) * packed_size::value;
+                size_t bytes = String_Comparer::WorkspaceBytes(c1Chars, c2Chars) + c1Chars + c2Chars;
+                try
+                {
+                    std::optional<Memory_Reservation> reserved = options_.memory->tryReserve(bytes);
+                    if (!reserved)
+                    {
+                        if (options_.memory->policy() == Memory_Budget::Policy::wait)
+                            segment.memory.release();
+                        reserved = options_.memory->reserve(bytes);
+                    }
+                    workspace = std::move(*reserved);
+                }
+                catch (const Memory_Budget_Exceeded&)
+                {
+                    segment.stopped = true;
+                    break;
+                }
 
-            trailingNonTelomereCharsOnC1_ = 0;
-            trailingNonTelomereCharsOnC2_ = 0;
+                // A table this thread kept from a comparison without a budget may be
+                // larger than what was reserved.
+                String_Comparer::ReleaseWorkspace();
+            }
 
-            String_Comparer stringComparer;
-            transforms = stringComparer.Compare(c1String, c2String);
+            size_t c1BytesBefore = segment.c1Bytes;
+            size_t c2BytesBefore = segment.c2Bytes;
+            string c1String = getNextChunkOfChars(c1, trailingOnC1, chunkBytes, segment.c1Bytes);
+            string c2String = getNextChunkOfChars(c2, trailingOnC2, chunkBytes, segment.c2Bytes);
 
-            // Now we need to update the index for each of the transforms to offset them
-            // by the bytes we've read so far from the first chromosome.  That way, all
-            // indices will be relative to the start of the first chromosome.
-            for (auto& t : transforms)
+            trailingOnC1 = 0;
+            trailingOnC2 = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            size_t found = segment.transformations.size();
+            size_t editedBases = compareChunkPair(c1String, c2String, indexSoFar, segment.transformations);
+            if (options_.progress != nullptr)
+                options_.progress->record(num_, c1String.size(), c2String.size(), segment.transformations.size() - found);
+            if (options_.adaptiveChunking)
+            {
+                // What was actually read, which at the ends of the streams is less than was
+                // asked for.  The DP table grows with the product of the two, so its cost is
+                // that of a square chunk of their geometric mean.
+                double read = std::sqrt(static_cast<double>(segment.c1Bytes - c1BytesBefore) *
+                                        static_cast<double>(segment.c2Bytes - c2BytesBefore));
+                chunkSizes.record(static_cast<size_t>(std::lround(read)), std::chrono::steady_clock::now() - start, editedBases);
+            }
+            if (options_.memory != nullptr)
             {
-                t.index += c1BytesSoFar;
+                // The thread's DP table goes with the reservation, or the pool's threads
+                // would each keep the largest one they ever built.
+                String_Comparer::ReleaseWorkspace();
+                workspace.release();
+                segment.memory.grow((segment.transformations.size() - found) * sizeof(Transformation));
             }
 
-            // Append the transforms to those that have been discovered so far from earlier chunks.
-            comparison.transformations.insert(comparison.transformations.end(), transforms.begin(), transforms.end());
+            // The chunk now reads like c2's.
+            indexSoFar += c2String.size();
+        }
+
+        // Nor can anything wait on a segment that is done: a finished segment's charge
+        // would otherwise hold up every other one until Finish().
+        if (options_.memory != nullptr && options_.memory->policy() == Memory_Budget::Policy::wait)
+            segment.memory.release();
+
+        segment.indexAtEnd = indexSoFar;
+        segment.c1Done = c1.atEnd();
+        segment.c2Done = c2.atEnd();
+        segment.trailingOnC1 = trailingOnC1;
+        segment.trailingOnC2 = trailingOnC2;
+    }
 
-            // Update the bytes read so far.
-            c1BytesSoFar += c1String.size();
+    template<typename Stream>
+    Chromosome_Comparison Basic_Chromosome_Comparer<Stream>::finish(vector<Comparison_Segment>& segments, bool reposition)
+    {
+        Chromosome_Comparison comparison;
+        comparison.chromosome = num_;
+        comparison.c1Start = c1Start();
+        comparison.c2Start = c2Start();
+
+        // Segments past the one in which either chromosome ended compared nothing real.
+        vector<vector<Transformation>*> pieces;
+        const Comparison_Segment* lastCompared = nullptr;
+        for (auto& segment : segments)
+        {
+            pieces.push_back(&segment.transformations);
+            segment.memory.release();
+            lastCompared = &segment;
+            if (segment.stopped || segment.c1Done || segment.c2Done)
+                break;
         }
+        if (lastCompared == nullptr)
+            return comparison;
+
+        if (lastCompared->stopped)
+        {
+            // The streams got as far as their own chunk sizes took them, so each
+            // resumes from its own offset.  The chunk-boundary clean-up waits until
+            // the comparison is whole.
+            comparison.complete = false;
+            comparison.resumeFrom = lastCompared->begin + lastCompared->c1Bytes;
+            comparison.resumeFromOnC2 = lastCompared->c2Begin + lastCompared->c2Bytes;
+            store(comparison, pieces, false);
+            return comparison;
+        }
+
+        size_t indexSoFar = lastCompared->indexAtEnd;
+        int trailingOnC1 = lastCompared->trailingOnC1;
+        int trailingOnC2 = lastCompared->trailingOnC2;
+        size_t ignored = 0;
+        vector<Transformation> rest;
 
-        if (c1_.atEnd() && !c2_.atEnd())
+        if (lastCompared->c1Done && !lastCompared->c2Done)
         {
             // c1 is done.  Get the remaining chunks from c2 and mark them as deletions.
+            if (reposition)
+                c2_.seek(c2Start_ + lastCompared->c2Begin + lastCompared->c2Bytes);
+
             string remainingChars;
             while (!c2_.atEnd())
             {
-                remainingChars += getNextChunkOfChars(c2_, trailingNonTelomereCharsOnC2_);
+                remainingChars += getNextChunkOfChars(c2_, trailingOnC2, 0, ignored);
             }
 
             // Put the remaining characters in an insertion transformation.
             // Append that insertion to the accumulated transformations.
-            comparison.transformations.emplace_back(Transformation(c1BytesSoFar, INSERTION, remainingChars));
+            rest.emplace_back(indexSoFar, INSERTION, remainingChars);
+            if (options_.progress != nullptr)
+                options_.progress->record(num_, 0, remainingChars.size(), 1);
         }
-        else if (!c1_.atEnd() && c2_.atEnd())
+        else if (!lastCompared->c1Done && lastCompared->c2Done)
         {
             // c2 is done.  Get the remaining chunks from c1 and mark them as insertions.
+            if (reposition)
+                c1_.seek(c1Start_ + lastCompared->begin + lastCompared->c1Bytes);
+
             string remainingChars;
             while (!c1_.atEnd())
             {
-                remainingChars += getNextChunkOfChars(c1_, trailingNonTelomereCharsOnC1_);
+                remainingChars += getNextChunkOfChars(c1_, trailingOnC1, 0, ignored);
             }
 
             // Put the remaining characters in a deletion transformation.
             // Append that insertion to the accumulated transformations.
-            comparison.transformations.emplace_back(Transformation(c1BytesSoFar, DELETION, remainingChars));
+            rest.emplace_back(indexSoFar, DELETION, remainingChars);
+            if (options_.progress != nullptr)
+                options_.progress->record(num_, remainingChars.size(), 0, 1);
+        }
+
+        pieces.push_back(&rest);
+        store(comparison, pieces, true);
+        if (options_.progress != nullptr)
+            options_.progress->finish(num_);
+        return comparison;
+    }
+
+    template<typename Stream>
+    size_t Basic_Chromosome_Comparer<Stream>::compareChunkPair(const string& c1String, const string& c2String,
+                                                               size_t indexSoFar, vector<Transformation>& transformations) const
+    {
+        String_Comparer stringComparer;
+        vector<Transformation> transforms = stringComparer.Compare(c1String, c2String);
+
+        // Now we need to update the index for each of the transforms to offset them
+        // by where the chunk starts once the earlier transformations are applied.  That
+        // way, all indices will be relative to the start of the first chromosome.
+        size_t editedBases = 0;
+        for (auto& t : transforms)
+        {
+            t.index += indexSoFar;
+            editedBases += t.s1.size();
         }
 
+        // Append the transforms to those that have been discovered so far from earlier chunks.
+        transformations.insert(transformations.end(), transforms.begin(), transforms.end());
+        return editedBases;
+    }
+
+    template<typename Stream>
+    void Basic_Chromosome_Comparer<Stream>::store(Chromosome_Comparison& comparison,
+                                                  const vector<vector<Transformation>*>& pieces, bool splice) const
+    {
+        size_t total = 0;
+        for (const auto* piece : pieces)
+            total += piece->size();
+
+        // Packed one at a time as they go, when asked for, so that the whole comparison
+        // never has to be held as Transformations at once.
+        auto keep = [&](Transformation&& t) {
+            if (options_.packTransformations)
+                comparison.packedTransformations.push_back(t);
+            else
+                comparison.transformations.push_back(std::move(t));
+        };
+        if (options_.packTransformations)
+            comparison.packedTransformations.reserve(total);
+        else
+            comparison.transformations.reserve(total);
+
         // Now do some post-processing to make sure that we didn't
         // mis-identify transformations due to the mis-alignment at the
-        // chunk boundaries.
-        if (!comparison.transformations.empty())
+        // chunk boundaries.  Each one is held until we have seen the one after it.
+        std::optional<Transformation> held;
+        for (auto* piece : pieces)
         {
-            size_t last = comparison.transformations.size() - 1;
-            size_t i = 0;
-            while (i < last)
+            for (auto& t : *piece)
             {
-                // If the two adjacent transformations cancel each other out, then remove them.
-                if (shouldSpliceAt(comparison.transformations, i))
+                if (held)
                 {
-                    vector<Transformation>::iterator first = comparison.transformations.begin() + i;
-                    vector<Transformation>::iterator second = first + 1;
-                    comparison.transformations.erase(first, second);
-                    last -= 2;
+                    // If the two adjacent transformations cancel each other out, then
+                    // remove them both.  Together they change nothing, so the indices
+                    // after them stay as they are.
+                    bool cancels = shouldSplice(*held, t);
+                    if (!cancels)
+                        keep(std::move(*held));
+                    held.reset();
+                    if (cancels)
+                        continue;
                 }
-                i++;
+
+                if (splice)
+                    held = std::move(t);
+                else
+                    keep(std::move(t));
             }
+            vector<Transformation>().swap(*piece);
         }
-
-        return comparison;
+        if (held)
+            keep(std::move(*held));
     }
 
-    string Chromosome_Comparer::unpackChunk(const sequence_buffer<byte_view>& bytes)
+    template<typename Stream>
+    string Basic_Chromosome_Comparer<Stream>::unpackChunk(const sequence_buffer<byte_view>& bytes) const
     {
-        // Convert each byte in the chunk to characters to build a string.
-        std::ostringstream ostr;
+        // Convert each base in the chunk to a character to build a string.
+        string chars(bytes.size(), 'A');
         for (size_t i=0; i<bytes.size(); i++)
         {
-            ostr << to_char(bytes[i]);
+            chars[i] = to_char(bytes[i]);
         }
-        return ostr.str();
+        return chars;
     }
 
-    int Chromosome_Comparer::initializeStream(DNA_Stream& stream, bool trackBytesRead)
+    template<typename Stream>
+    int Basic_Chromosome_Comparer<Stream>::initializeStream(Stream& stream, size_t& start, bool trackBytesRead)
     {
+        // Always from the top, so that the same streams can be compared again.
+        stream.seek(0);
         size_t charsRead = 0;
         sequence_buffer<byte_view> currentBytes = stream.read();
         charsRead += currentBytes.size();
@@ -131,7 +455,7 @@ namespace dna
 
         // Now look for telomere fragments at the beginning of the string.
         size_t telomereFragmentSize = 0;
-        for (const auto& fragment : LEADING_TELOMERE_FRAGMENTS)
+        for (auto fragment : telomere::leading_fragments)
         {
             if (chars.starts_with(fragment))
             {
@@ -166,6 +490,7 @@ namespace dna
         auto offset = endOfTelomeres / packed_size::value;
         int charsToIgnoreFromLastTelomere = endOfTelomeres % packed_size::value;
         stream.seek(offset);
+        start = offset;
 
         if (trackBytesRead)
         {
@@ -181,18 +506,19 @@ namespace dna
         return charsToIgnoreFromLastTelomere;
     }
 
-    bool Chromosome_Comparer::findFullTelomeresInChars(
+    template<typename Stream>
+    bool Basic_Chromosome_Comparer<Stream>::findFullTelomeresInChars(
         const string& chars,
         size_t startPoint,
         const string& previousChars,
-        string& nextPrefix)
+        string& nextPrefix) const
     {
         string charsToSearch = previousChars.empty() ? chars : previousChars + chars;
 
         // Advance past all telomeres found.
-        while (charsToSearch.find(TELOMERE, startPoint) == startPoint)
+        while (charsToSearch.find(telomere::text, startPoint) == startPoint)
         {
-            startPoint += TELOMERE.size();
+            startPoint += telomere::size;
         }
 
         // Now see if there's much left in this chunk.
@@ -201,11 +527,11 @@ namespace dna
         // fragment plus the next chunk.
         auto remainingChars = charsToSearch.size() - startPoint;
         nextPrefix = charsToSearch.substr(startPoint, remainingChars);
-        if (remainingChars > 0 && remainingChars < TELOMERE.size())
+        if (remainingChars > 0 && remainingChars < telomere::size)
         {
             return true;
         }
-        else if (remainingChars >= TELOMERE.size())
+        else if (remainingChars >= telomere::size)
         {
             // There are no more telomeres.
             return false;
@@ -217,29 +543,30 @@ namespace dna
         return true;
     }
 
-    string Chromosome_Comparer::getNextChunkOfChars(DNA_Stream& stream, int& trailingNonTelomereChars)
+    template<typename Stream>
+    string Basic_Chromosome_Comparer<Stream>::getNextChunkOfChars(Stream& stream, int& trailingNonTelomereChars, size_t chunkBytes,
+                                                                 size_t& bytesRead) const
     {
-        auto c1Chunk = stream.read();
-        string charString = unpackChunk(c1Chunk);
-        if (trailingNonTelomereChars > 0)
-        {
-            // Prepend the non-telomere characters that were found during
-            // initialization of cthe stream.
-            charString.erase(0, trailingNonTelomereChars);
-            trailingNonTelomereChars = 0;
-        }
-
-        // Now see if there's a telomere in this chunk.
-        auto telomereIndex = charString.find(TELOMERE);
-        if (telomereIndex != string::npos)
+        auto c1Chunk = chunkBytes > 0 ? stream.read(chunkBytes) : stream.read();
+        bytesRead += c1Chunk.buffer().size();
+
+        // The stream starts in the byte that holds the end of the last leading telomere.
+        // Start the characters after it.
+        auto chunk = c1Chunk.subsequence(static_cast<size_t>(trailingNonTelomereChars));
+        string charString = unpackChunk(chunk);
+        trailingNonTelomereChars = 0;
+
+        // Now see if there's a telomere in this chunk, scanning the packed bases.
+        auto telomereIndex = telomere::find(chunk);
+        if (telomereIndex != telomere::npos)
         {
             // Found one.  Is it just a random sequence, or does it indicate
             // the start of the telomeres on the end of the chromosome?
             // See if we can find another one.
-            auto remainingChars = charString.size() - (telomereIndex + TELOMERE.size());
-            if (remainingChars >= TELOMERE.size())
+            auto remainingChars = charString.size() - (telomereIndex + telomere::size);
+            if (remainingChars >= telomere::size)
             {
-                if (charString.find(TELOMERE, telomereIndex + TELOMERE.size()))
+                if (telomere::find(chunk, telomereIndex + telomere::size))
                 {
                     // We found another whole one.  Let's assume that this means
                     // that we have found the start of the ending telomeres.
@@ -253,8 +580,8 @@ namespace dna
             {
                 // The distance from the telomere to the end of the chunk is smaller than
                 // the length of a telomere.  Let's see if we find a telomere fragment.
-                string fragmentCandidate = TAILING_TELOMERE_FRAGMENTS[TELOMERE.size() - 1 - remainingChars];
-                if (charString.find(fragmentCandidate, telomereIndex + TELOMERE.size()))
+                auto fragmentCandidate = telomere::trailing_fragments[telomere::size - 1 - remainingChars];
+                if (charString.find(fragmentCandidate, telomereIndex + telomere::size))
                 {
                     // Found the telomere fragment.  Assume this means that we have reached
                     // the ending telomeres.
@@ -279,22 +606,211 @@ namespace dna
         return charString;
     }
 
-    bool Chromosome_Comparer::shouldSpliceAt(const vector<Transformation>& transforms, size_t i)
+    template<typename Stream>
+    bool Basic_Chromosome_Comparer<Stream>::shouldSplice(const Transformation& first, const Transformation& second) const
     {
         // If we inserted a string at the end of one chunk and then deleted the same string
         // at the beginning of the next chunk, then these two adjacent transformations
-        // cancel each other out.
-
-        if (transforms[i].index == transforms[i + 1].index &&
-            transforms[i].s1 == transforms[i + 1].s1)
+        // cancel each other out.  The deletion is of what follows the inserted string;
+        // the other way round, the string goes back where it was deleted from.
+        if (first.s1 == second.s1)
         {
-            if (transforms[i].type == INSERTION && transforms[i + 1].type == DELETION)
+            if (first.type == INSERTION && second.type == DELETION &&
+                second.index == first.index + first.s1.size())
                 return true;
-            if (transforms[i].type == DELETION && transforms[i + 1].type == INSERTION)
+            if (first.type == DELETION && second.type == INSERTION && second.index == first.index)
                 return true;
         }
-            
+
         return false;
     }
 
+    template<typename Stream>
+    Basic_Fan_Out_Comparer<Stream>::Basic_Fan_Out_Comparer(int number, Stream& query,
+                                                           const vector<std::reference_wrapper<Stream>>& targets,
+                                                           const Comparison_Options& options) :
+        num_(number), query_(query), options_(options)
+    {
+        options_.adaptiveChunking = false;
+        targets_.reserve(targets.size());
+        for (Stream& target : targets)
+            targets_.emplace_back(number, query, target, options_);
+    }
+
+    template<typename Stream>
+    vector<Chromosome_Comparison> Basic_Fan_Out_Comparer<Stream>::Compare(Work_Stealing_Pool& pool, size_t batchChunks)
+    {
+        vector<Chromosome_Comparison> comparisons;
+        if (targets_.empty())
+            return comparisons;
+
+        // Skip the query's leading telomeres once, on behalf of every comparison, and
+        // each target's in parallel.
+        auto& first = targets_.front().comparer;
+        int trailingOnQuery = first.initializeStream(query_, first.c1Start_, true);
+        {
+            Task_Group group(pool);
+            for (auto& target : targets_)
+            {
+                target.comparer.c1Start_ = first.c1Start_;
+                target.comparer.bytesReadFromC1_ = first.bytesReadFromC1_;
+                target.comparer.trailingNonTelomereCharsOnC1_ = trailingOnQuery;
+                target.indexSoFar = first.bytesReadFromC1_;
+                group.run([&target] {
+                    target.trailing = target.comparer.initializeStream(target.comparer.c2_, target.comparer.c2Start_, false);
+                    target.comparer.trailingNonTelomereCharsOnC2_ = target.trailing;
+                });
+            }
+            group.wait();
+        }
+
+        // Unpack a batch of query chunks, then let every comparison catch up with it.
+        vector<string> batch;
+        vector<size_t> batchBytes;
+        while (!query_.atEnd())
+        {
+            if (options_.cancellation != nullptr && options_.cancellation->stopRequested())
+                break;
+
+            batch.clear();
+            batchBytes.clear();
+            while (batch.size() < std::max<size_t>(batchChunks, 1) && !query_.atEnd())
+            {
+                size_t bytes = 0;
+                batch.push_back(first.getNextChunkOfChars(query_, trailingOnQuery, 0, bytes));
+                batchBytes.push_back(bytes);
+                trailingOnQuery = 0;
+            }
+
+            Task_Group group(pool);
+            for (auto& target : targets_)
+                group.run([this, &target, &batch, &batchBytes] { advance(target, batch, batchBytes); });
+            group.wait();
+        }
+
+        // Stopped before the end of the query, every comparison has the rest to do.
+        bool queryStopped = !query_.atEnd();
+        bool stopped = false;
+        for (auto& target : targets_)
+        {
+            target.stopped = target.stopped || queryStopped;
+            stopped = stopped || target.stopped;
+        }
+
+        comparisons.resize(targets_.size());
+        Task_Group group(pool);
+        for (size_t i = 0; i < targets_.size(); i++)
+            group.run([this, i, &comparisons] { comparisons[i] = finish(targets_[i]); });
+        group.wait();
+
+        if (options_.progress != nullptr && !stopped)
+            options_.progress->finish(num_);
+        return comparisons;
+    }
+
+    template<typename Stream>
+    void Basic_Fan_Out_Comparer<Stream>::advance(Target& target, const vector<string>& batch,
+                                                 const vector<size_t>& batchBytes) const
+    {
+        Stream& c2 = target.comparer.c2_;
+        for (size_t i = 0; i < batch.size() && !target.stopped; i++)
+        {
+            const string& c1String = batch[i];
+
+            // Once the target has run out, the rest of the query is one long deletion.
+            if (target.ended || c2.atEnd())
+            {
+                target.ended = true;
+                target.remainingQuery += c1String;
+                continue;
+            }
+
+            if (options_.cancellation != nullptr && options_.cancellation->stopRequested())
+            {
+                target.stopped = true;
+                break;
+            }
+
+            // Hold the DP table and both unpacked chunks against the budget.  Nothing else
+            // is held between chunks, so waiting here can't wait on ourselves.
+            Memory_Reservation workspace;
+            if (options_.memory != nullptr)
+            {
+                size_t c1Chars = query_.chunkSize() * packed_size::value;
+                size_t c2Chars = c2.chunkSize() * packed_size::value;
+                try
+                {
+                    workspace = options_.memory->reserve(String_Comparer::WorkspaceBytes(c1Chars, c2Chars) + c1Chars + c2Chars);
+                }
+                catch (const Memory_Budget_Exceeded&)
+                {
+                    target.stopped = true;
+                    break;
+                }
+                String_Comparer::ReleaseWorkspace();
+            }
+
+            string c2String = target.comparer.getNextChunkOfChars(c2, target.trailing, 0, target.c2Bytes);
+            target.trailing = 0;
+            size_t found = target.transformations.size();
+            target.comparer.compareChunkPair(c1String, c2String, target.indexSoFar, target.transformations);
+            if (options_.memory != nullptr)
+            {
+                String_Comparer::ReleaseWorkspace();
+                workspace.release();
+            }
+            if (options_.progress != nullptr)
+                options_.progress->record(num_, c1String.size(), c2String.size(), target.transformations.size() - found);
+            target.indexSoFar += c2String.size();
+            target.c1Bytes += batchBytes[i];
+        }
+    }
+
+    template<typename Stream>
+    Chromosome_Comparison Basic_Fan_Out_Comparer<Stream>::finish(Target& target) const
+    {
+        Chromosome_Comparison comparison;
+        comparison.chromosome = num_;
+        comparison.c1Start = target.comparer.c1Start();
+        comparison.c2Start = target.comparer.c2Start();
+
+        // Whatever was run out of, it resumes from the first chunk it didn't compare.
+        if (target.stopped)
+        {
+            comparison.complete = false;
+            comparison.resumeFrom = target.c1Bytes;
+            comparison.resumeFromOnC2 = target.c2Bytes;
+            target.comparer.store(comparison, { &target.transformations }, false);
+            return comparison;
+        }
+
+        Stream& c2 = target.comparer.c2_;
+        vector<Transformation> rest;
+        if (target.ended)
+        {
+            rest.emplace_back(target.indexSoFar, DELETION, target.remainingQuery);
+        }
+        else if (!c2.atEnd())
+        {
+            // The query is done.  The rest of the target is an insertion.
+            string remainingChars;
+            size_t ignored = 0;
+            while (!c2.atEnd())
+            {
+                remainingChars += target.comparer.getNextChunkOfChars(c2, target.trailing, 0, ignored);
+            }
+            rest.emplace_back(target.indexSoFar, INSERTION, remainingChars);
+        }
+
+        target.comparer.store(comparison, { &target.transformations, &rest }, true);
+        return comparison;
+    }
+
+    template class Basic_Chromosome_Comparer<DNA_Stream>;
+    template class Basic_Chromosome_Comparer<File_Stream>;
+    template class Basic_Chromosome_Comparer<Object_Store_Stream>;
+
+    template class Basic_Fan_Out_Comparer<DNA_Stream>;
+    template class Basic_Fan_Out_Comparer<File_Stream>;
+    template class Basic_Fan_Out_Comparer<Object_Store_Stream>;
 }
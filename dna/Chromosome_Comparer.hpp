@@ -1,37 +1,163 @@
 #pragma once
 
+#include <concepts>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include "DNA_Stream.hpp"
+#include "File_Stream.hpp"
+#include "Object_Store_Stream.hpp"
 #include "Transformation.hpp"
 #include "Chromosome_Comparison.hpp"
+#include "Comparison_Options.hpp"
+#include "Work_Stealing_Pool.hpp"
 
 using std::string;
 using std::vector;
 
 namespace dna
 {
-    class Chromosome_Comparer
+    // One independently comparable piece of a chromosome comparison.  begin and end are
+    // byte offsets into c1 counted from the end of its leading telomeres, and c2Begin is
+    // where c2 starts, counted the same way; the rest is filled in by comparing the
+    // segment.
+    struct Comparison_Segment
+    {
+        size_t begin = 0;
+        size_t end = static_cast<size_t>(-1);
+        size_t c2Begin = 0;         // the same as begin, except when resuming streams
+                                    // whose chunk sizes differ
+        vector<Transformation> transformations;
+        size_t indexAtEnd = 0;      // where a transformation just past the compared
+                                    // characters would go
+        size_t c1Bytes = 0;         // bytes consumed from each chromosome
+        size_t c2Bytes = 0;
+        bool c1Done = false;        // the chromosome ran out (or into its tailing telomeres)
+        bool c2Done = false;
+        int trailingOnC1 = 0;       // telomere characters still to skip, if nothing was read
+        int trailingOnC2 = 0;
+        bool stopped = false;       // the cancellation token or memory budget stopped it
+        Memory_Reservation memory;  // what the transformations are charged to the budget,
+                                    // while comparing under the wait policy
+    };
+
+    // Compares two chromosomes chunk by chunk.  Stream is any helix stream that can
+    // also report atEnd() and advanceToEnd(); DNA_Stream, File_Stream and Object_Store_Stream
+    // are instantiated in Chromosome_Comparer.cpp.
+    template<typename Stream>
+    class Basic_Chromosome_Comparer
     {
         int num_;
-        DNA_Stream& c1_;
-        DNA_Stream& c2_;
+        std::shared_ptr<Stream> opposite_;     // c2's opposite strand, when asked for
+        Stream& c1_;
+        Stream& c2_;
+        Comparison_Options options_;
         int trailingNonTelomereCharsOnC1_ = 0;
         int trailingNonTelomereCharsOnC2_ = 0;
         size_t bytesReadFromC1_ = 0;
+        size_t c1Start_ = 0;
+        size_t c2Start_ = 0;
+
+        template<typename> friend class Basic_Fan_Out_Comparer;
 
     public:
-        Chromosome_Comparer(int number, DNA_Stream& c1, DNA_Stream& c2);
+        Basic_Chromosome_Comparer(int number, Stream& c1, Stream& c2, const Comparison_Options& options = {});
         Chromosome_Comparison Compare();
 
+        // Carry on with a comparison that was stopped early, and return the whole of it.
+        Chromosome_Comparison Resume(const Chromosome_Comparison& partial);
+
+        // The same comparison in pieces, so that one chromosome can be spread over many
+        // threads: Prepare() once, compare each of the segments from Split() in any order
+        // and on any thread, then Finish() with all of them, in order.  Segments of the
+        // streams' chunk size multiples find exactly what Compare() finds.
+        void Prepare();
+        vector<Comparison_Segment> Split(size_t segmentBytes) const;
+
+        // Where the comparison starts on each chromosome, in bases: just past its leading
+        // telomeres.  Known once Prepare() has been called.
+        size_t c1Start() const;
+        size_t c2Start() const;
+        void CompareSegment(Comparison_Segment& segment) const requires std::copy_constructible<Stream>;
+        Chromosome_Comparison Finish(vector<Comparison_Segment>& segments);
+
+        // Compare() with the segments spread over the pool.
+        Chromosome_Comparison Compare(Work_Stealing_Pool& pool, size_t segmentBytes)
+            requires std::copy_constructible<Stream>;
+
     private:
-        string unpackChunk(const sequence_buffer<byte_view>& bytes);
-        int initializeStream(DNA_Stream& stream, bool trackBytesRead);
+        void compareChunks(Stream& c1, Stream& c2, Comparison_Segment& segment) const;
+        Chromosome_Comparison finish(vector<Comparison_Segment>& segments, bool reposition);
+        size_t compareChunkPair(const string& c1String, const string& c2String,
+                                size_t indexSoFar, vector<Transformation>& transformations) const;
+        void store(Chromosome_Comparison& comparison, const vector<vector<Transformation>*>& pieces, bool splice) const;
+        string unpackChunk(const sequence_buffer<byte_view>& bytes) const;
+        int initializeStream(Stream& stream, size_t& start, bool trackBytesRead);
         bool findFullTelomeresInChars(const string& chars,
             size_t startPoint,
             const string& previous_chars,
-            string& nextPrefix);
-        string getNextChunkOfChars(DNA_Stream& stream, int& trailingTelomereChars);
-        bool shouldSpliceAt(const vector<Transformation>& transforms, size_t i);
+            string& nextPrefix) const;
+        string getNextChunkOfChars(Stream& stream, int& trailingTelomereChars, size_t chunkBytes, size_t& bytesRead) const;
+        bool shouldSplice(const Transformation& first, const Transformation& second) const;
     };
+
+    // Compares one chromosome against the corresponding chromosomes of many others.  The
+    // query is read, trimmed and unpacked only once: each batch of its chunks is shared
+    // by all of the comparisons, which advance through it side by side on the pool.
+    // Always uses the streams' own chunk sizes, and finds exactly what one Compare()
+    // per target would find.  The options apply to every comparison: one that is
+    // cancelled or runs out of memory comes back incomplete, and Resume() on a
+    // Basic_Chromosome_Comparer of the same two streams finishes it.  Adaptive chunking
+    // doesn't apply, since the query's chunks are shared.
+    template<typename Stream>
+    class Basic_Fan_Out_Comparer
+    {
+        struct Target
+        {
+            Basic_Chromosome_Comparer<Stream> comparer;
+            vector<Transformation> transformations;
+            size_t indexSoFar = 0;
+            size_t c1Bytes = 0;         // bytes of each chromosome compared so far
+            size_t c2Bytes = 0;
+            int trailing = 0;
+            bool ended = false;         // the target ran out before the query did
+            bool stopped = false;       // cancelled, or out of memory
+            string remainingQuery;      // the query characters past that point
+
+            Target(int number, Stream& query, Stream& target, const Comparison_Options& options) :
+                comparer(number, query, target, options)
+            { }
+        };
+
+        int num_;
+        Stream& query_;
+        Comparison_Options options_;
+        vector<Target> targets_;
+
+    public:
+        Basic_Fan_Out_Comparer(int number, Stream& query, const vector<std::reference_wrapper<Stream>>& targets,
+                               const Comparison_Options& options = {});
+
+        // One comparison per target, in the order of the targets.
+        vector<Chromosome_Comparison> Compare(Work_Stealing_Pool& pool, size_t batchChunks = 64);
+
+    private:
+        void advance(Target& target, const vector<string>& batch, const vector<size_t>& batchBytes) const;
+        Chromosome_Comparison finish(Target& target) const;
+    };
+
+    using Chromosome_Comparer = Basic_Chromosome_Comparer<DNA_Stream>;
+    using File_Chromosome_Comparer = Basic_Chromosome_Comparer<File_Stream>;
+    using Object_Store_Chromosome_Comparer = Basic_Chromosome_Comparer<Object_Store_Stream>;
+
+    extern template class Basic_Chromosome_Comparer<DNA_Stream>;
+    extern template class Basic_Chromosome_Comparer<File_Stream>;
+    extern template class Basic_Chromosome_Comparer<Object_Store_Stream>;
+
+    using Fan_Out_Comparer = Basic_Fan_Out_Comparer<DNA_Stream>;
+
+    extern template class Basic_Fan_Out_Comparer<DNA_Stream>;
+    extern template class Basic_Fan_Out_Comparer<File_Stream>;
+    extern template class Basic_Fan_Out_Comparer<Object_Store_Stream>;
 }
@@ -1,12 +1,16 @@
 #include "Chromosome_Comparison.hpp"
 
+#include <iterator>
+
 namespace dna
 {
     Chromosome_Comparison::Chromosome_Comparison() : chromosome(0)
     {
     }
     
-    Chromosome_Comparison::Chromosome_Comparison(const Chromosome_Comparison& other) : chromosome(other.chromosome), transformations(other.transformations)
+    Chromosome_Comparison::Chromosome_Comparison(const Chromosome_Comparison& other) : chromosome(other.chromosome), transformations(other.transformations),
+        c1Start(other.c1Start), c2Start(other.c2Start), complete(other.complete), resumeFrom(other.resumeFrom), resumeFromOnC2(other.resumeFromOnC2),
+        packedTransformations(other.packedTransformations)
     {
     }
     
@@ -14,6 +18,12 @@ namespace dna
     {
         chromosome = other.chromosome;
         transformations = std::move(other.transformations);
+        c1Start = other.c1Start;
+        c2Start = other.c2Start;
+        complete = other.complete;
+        resumeFrom = other.resumeFrom;
+        resumeFromOnC2 = other.resumeFromOnC2;
+        packedTransformations = std::move(other.packedTransformations);
     }
 
     Chromosome_Comparison& Chromosome_Comparison::operator= (const Chromosome_Comparison& other)
@@ -22,6 +32,12 @@ namespace dna
         {
             chromosome = other.chromosome;
             transformations = other.transformations;
+            c1Start = other.c1Start;
+            c2Start = other.c2Start;
+            complete = other.complete;
+            resumeFrom = other.resumeFrom;
+            resumeFromOnC2 = other.resumeFromOnC2;
+            packedTransformations = other.packedTransformations;
         }
         return *this;
     }
@@ -32,8 +48,77 @@ namespace dna
         {
             chromosome = other.chromosome;
             transformations = std::move(other.transformations);
+            c1Start = other.c1Start;
+            c2Start = other.c2Start;
+            complete = other.complete;
+            resumeFrom = other.resumeFrom;
+            resumeFromOnC2 = other.resumeFromOnC2;
+            packedTransformations = std::move(other.packedTransformations);
         }
         return *this;
     }
-        
-}
\ No newline at end of file
+
+    void Chromosome_Comparison::pack()
+    {
+        if (packedTransformations.empty())
+            packedTransformations = Packed_Transformations(transformations);
+        else
+            for (const auto& t : transformations)
+                packedTransformations.push_back(t);
+        vector<Transformation>().swap(transformations);
+    }
+
+    void Chromosome_Comparison::unpack()
+    {
+        vector<Transformation> unpacked = packedTransformations.unpack();
+        transformations.insert(transformations.end(), std::make_move_iterator(unpacked.begin()),
+                               std::make_move_iterator(unpacked.end()));
+        packedTransformations = Packed_Transformations();
+    }
+
+    Chromosome_Comparison Invert(const Chromosome_Comparison& comparison)
+    {
+        if (!comparison.packedTransformations.empty())
+        {
+            Chromosome_Comparison unpacked = comparison;
+            unpacked.unpack();
+            Chromosome_Comparison inverse = Invert(unpacked);
+            inverse.pack();
+            return inverse;
+        }
+
+        Chromosome_Comparison inverse;
+        inverse.chromosome = comparison.chromosome;
+        inverse.c1Start = comparison.c2Start;
+        inverse.c2Start = comparison.c1Start;
+        inverse.complete = comparison.complete;
+        inverse.resumeFrom = comparison.resumeFromOnC2;
+        inverse.resumeFromOnC2 = comparison.resumeFrom;
+        inverse.transformations.reserve(comparison.transformations.size());
+
+        // Each index is into the string with all earlier transformations applied.  Undoing
+        // them in the same order, the earlier ones have already been undone, so the index
+        // moves back by however much they grew the string, and over from A's leading
+        // telomeres to B's.
+        long long growth = static_cast<long long>(comparison.c1Start) - static_cast<long long>(comparison.c2Start);
+        for (const auto& t : comparison.transformations)
+        {
+            size_t index = static_cast<size_t>(static_cast<long long>(t.index) - growth);
+            if (t.type == INSERTION)
+            {
+                inverse.transformations.emplace_back(index, DELETION, t.s1);
+                growth += static_cast<long long>(t.s1.size());
+            }
+            else if (t.type == DELETION)
+            {
+                inverse.transformations.emplace_back(index, INSERTION, t.s1);
+                growth -= static_cast<long long>(t.s1.size());
+            }
+            else
+            {
+                inverse.transformations.emplace_back(index, SUBSTITUTION, t.s2, t.s1);
+            }
+        }
+        return inverse;
+    }
+}
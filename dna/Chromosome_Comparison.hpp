@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "Transformation.hpp"
+#include "Packed_Transformations.hpp"
 
 using std::vector;
 
@@ -11,8 +12,31 @@ namespace dna
     struct Chromosome_Comparison
     {
         int chromosome = 0;
+
+        // Applied in order, the transformations turn c1 into c2, keeping c1's leading
+        // telomeres.  Each index is into c1 with all of the earlier ones applied.
         vector<Transformation> transformations;
 
+        // Where each chromosome starts past its leading telomeres, in bases.  The
+        // indices count c1's telomeres; another start puts them somewhere else.
+        size_t c1Start = 0;
+        size_t c2Start = 0;
+
+        // A comparison that was stopped early holds only the transformations found
+        // before resumeFrom, a byte offset into c1 from the end of its leading telomeres.
+        // c2 resumes from resumeFromOnC2, counted the same way, which differs from
+        // resumeFrom when the streams' chunk sizes do.
+        bool complete = true;
+        size_t resumeFrom = 0;
+        size_t resumeFromOnC2 = 0;
+
+        // The transformations can be kept packed instead, for holding many comparisons
+        // at once.  pack() moves them here and unpack() moves them back; only one of the
+        // two holds any at a time.
+        Packed_Transformations packedTransformations;
+        void pack();
+        void unpack();
+
         Chromosome_Comparison();
         Chromosome_Comparison(const Chromosome_Comparison& other);
         Chromosome_Comparison(Chromosome_Comparison&& other) noexcept;
@@ -20,4 +44,9 @@ namespace dna
         Chromosome_Comparison& operator= (Chromosome_Comparison&& other) noexcept;
     };
 
+    // Turn the comparison of A against B into the comparison of B against A, with its
+    // indices counting B's leading telomeres instead of A's.  Each transformation must
+    // start past where the one before it ended, as the comparers produce them.
+    Chromosome_Comparison Invert(const Chromosome_Comparison& comparison);
+
 }
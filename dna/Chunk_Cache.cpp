@@ -0,0 +1,109 @@
+#include "Chunk_Cache.hpp"
+
+namespace dna
+{
+    Chunk_Cache::Chunk_Cache(size_t capacityBytes) : capacity_(capacityBytes)
+    {
+    }
+
+    size_t Chunk_Cache::Key_Hash::operator()(const Key& key) const noexcept
+    {
+        size_t h = std::hash<string>()(key.object);
+        h ^= std::hash<std::uint64_t>()(key.store) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= std::hash<size_t>()(key.chunksize) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        h ^= std::hash<size_t>()(key.index) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    Chunk_Cache::Chunk_Ptr Chunk_Cache::get(const Key& key, const std::function<Chunk()>& load)
+    {
+        std::promise<Chunk_Ptr> promise;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            auto found = entries_.find(key);
+            if (found != entries_.end())
+            {
+                statistics_.hits++;
+                recency_.splice(recency_.begin(), recency_, found->second.position);
+                return found->second.chunk;
+            }
+
+            auto pending = loading_.find(key);
+            if (pending != loading_.end())
+            {
+                // Someone else is already fetching this chunk.  Share their result.
+                statistics_.hits++;
+                auto future = pending->second;
+                lock.unlock();
+                return future.get();
+            }
+
+            statistics_.misses++;
+            loading_.emplace(key, promise.get_future().share());
+        }
+
+        // Fetch without holding the lock; this is the slow part.
+        Chunk_Ptr chunk;
+        try
+        {
+            chunk = std::make_shared<const Chunk>(load());
+        }
+        catch (...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                loading_.erase(key);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            loading_.erase(key);
+            insert(key, chunk);
+        }
+        promise.set_value(chunk);
+        return chunk;
+    }
+
+    size_t Chunk_Cache::capacity() const
+    {
+        return capacity_;
+    }
+
+    Chunk_Cache::Statistics Chunk_Cache::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+    void Chunk_Cache::clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+        recency_.clear();
+        statistics_.bytes = 0;
+    }
+
+    // NB: Must be called with the mutex held.
+    void Chunk_Cache::insert(const Key& key, const Chunk_Ptr& chunk)
+    {
+        if (chunk->size() > capacity_ || entries_.count(key) > 0)
+            return;
+
+        recency_.push_front(key);
+        entries_.emplace(key, Entry{ chunk, recency_.begin() });
+        statistics_.bytes += chunk->size();
+
+        while (statistics_.bytes > capacity_)
+        {
+            const Key& oldest = recency_.back();
+            auto victim = entries_.find(oldest);
+            statistics_.bytes -= victim->second.chunk->size();
+            statistics_.evictions++;
+            entries_.erase(victim);
+            recency_.pop_back();
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Genome_Buffer.hpp"
+
+using std::string;
+using std::vector;
+
+namespace dna
+{
+    // A size-bounded, least recently used cache of chunks fetched from an object store.
+    // One cache is meant to be shared by every stream in the process, so that repeated
+    // comparisons against the same popular reference people are served from memory.
+    //
+    // Chunks are handed out as shared pointers, so evicting a chunk never pulls it out
+    // from under a reader.  Concurrent misses on the same chunk wait for a single fetch.
+    class Chunk_Cache
+    {
+    public:
+        using Chunk = vector<std::byte, aligned_allocator<std::byte>>;
+        using Chunk_Ptr = std::shared_ptr<const Chunk>;
+
+        struct Key
+        {
+            std::uint64_t store;        // Object_Store::id()
+            string object;
+            size_t chunksize;
+            size_t index;
+
+            bool operator==(const Key& other) const = default;
+        };
+
+        struct Statistics
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+            size_t bytes = 0;
+        };
+
+        explicit Chunk_Cache(size_t capacityBytes);
+
+        Chunk_Cache(const Chunk_Cache&) = delete;
+        Chunk_Cache& operator=(const Chunk_Cache&) = delete;
+
+        // Return the cached chunk, calling load to fetch it on a miss.
+        Chunk_Ptr get(const Key& key, const std::function<Chunk()>& load);
+
+        size_t capacity() const;
+        Statistics statistics() const;
+        void clear();
+
+    private:
+        struct Key_Hash
+        {
+            size_t operator()(const Key& key) const noexcept;
+        };
+
+        struct Entry
+        {
+            Chunk_Ptr chunk;
+            std::list<Key>::iterator position;
+        };
+
+        void insert(const Key& key, const Chunk_Ptr& chunk);
+
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        std::list<Key> recency_;        // most recently used at the front
+        std::unordered_map<Key, Entry, Key_Hash> entries_;
+        std::unordered_map<Key, std::shared_future<Chunk_Ptr>, Key_Hash> loading_;
+        Statistics statistics_;
+    };
+}
@@ -0,0 +1,38 @@
+#include "Chunk_Dispenser.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace dna
+{
+    Chunk_Dispenser::Chunk_Dispenser(const DNA_Stream& stream, size_t chunksize, size_t begin, size_t end) :
+        stream_(stream),
+        chunksize_(chunksize > 0 ? chunksize : stream.chunkSize()),
+        begin_(std::min(begin, stream.size())),
+        end_(std::max(begin_, std::min(end, stream.size())))
+    {
+        if (chunksize_ == 0)
+            throw std::invalid_argument("chunk size must be positive");
+
+        chunks_ = (end_ - begin_ + chunksize_ - 1) / chunksize_;
+    }
+
+    bool Chunk_Dispenser::next(Ticket& ticket)
+    {
+        // Unlike the CAS loop in DNA_Stream::read(), a plain fetch_add never retries:
+        // every caller gets a distinct sequence number in one atomic step.
+        size_t sequence = next_.fetch_add(1, std::memory_order_relaxed);
+        if (sequence >= chunks_)
+            return false;
+
+        ticket.sequence = sequence;
+        ticket.offset = begin_ + sequence * chunksize_;
+        ticket.chunk = stream_.view(ticket.offset, std::min(chunksize_, end_ - ticket.offset));
+        return true;
+    }
+
+    size_t Chunk_Dispenser::chunks() const
+    {
+        return chunks_;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "DNA_Stream.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // Hands out disjoint chunks of a stream to any number of worker threads.
+    // Every chunk comes with its sequence number, so that results which do need
+    // ordering can be put back together by an Ordered_Reassembler.  The stream's
+    // own read offset isn't touched.
+    class Chunk_Dispenser
+    {
+    public:
+        struct Ticket
+        {
+            size_t sequence = 0;
+            size_t offset = 0;      // byte offset of the chunk in the stream
+            sequence_buffer<byte_view> chunk = byte_view(nullptr, 0);
+        };
+
+        // Dispense [begin, end) of the stream in chunks of chunksize bytes.
+        // A chunksize of zero means the stream's own chunk size.
+        Chunk_Dispenser(const DNA_Stream& stream, size_t chunksize = 0,
+                        size_t begin = 0, size_t end = static_cast<size_t>(-1));
+
+        Chunk_Dispenser(const Chunk_Dispenser&) = delete;
+        Chunk_Dispenser& operator=(const Chunk_Dispenser&) = delete;
+
+        // Claim the next chunk.  Safe to call from any number of threads at once.
+        // Returns false once every chunk has been handed out.
+        bool next(Ticket& ticket);
+
+        // The total number of chunks, which is also one past the last sequence number.
+        size_t chunks() const;
+
+    private:
+        const DNA_Stream& stream_;
+        size_t chunksize_;
+        size_t begin_;
+        size_t end_;
+        size_t chunks_;
+        std::atomic<size_t> next_{0};
+    };
+
+    // Collects results that finish in any order and passes them to the sink in
+    // sequence order.  The sink is called under a lock, one result at a time.
+    template<typename T>
+    class Ordered_Reassembler
+    {
+        std::mutex mutex_;
+        std::map<size_t, T> pending_;
+        size_t next_ = 0;
+        std::function<void(size_t, T&&)> sink_;
+
+    public:
+        explicit Ordered_Reassembler(std::function<void(size_t, T&&)> sink, size_t first = 0) :
+            next_(first),
+            sink_(std::move(sink))
+        { }
+
+        void submit(size_t sequence, T result)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (sequence != next_)
+            {
+                pending_.emplace(sequence, std::move(result));
+                return;
+            }
+
+            sink_(next_++, std::move(result));
+            for (auto it = pending_.begin(); it != pending_.end() && it->first == next_; it = pending_.erase(it))
+                sink_(next_++, std::move(it->second));
+        }
+
+        // The number of results that have been passed to the sink so far.
+        size_t delivered()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return next_;
+        }
+
+        // The number of results waiting for an earlier one to arrive.
+        size_t waiting()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return pending_.size();
+        }
+    };
+
+    // Drain the dispenser with the given number of threads.  Each chunk is mapped to a
+    // result on whatever thread claimed it, and the results reach the sink in order.
+    // If map or sink throws, the other threads stop claiming chunks, and the first
+    // exception is rethrown once they have all finished.
+    template<typename Map, typename Sink>
+    void ParallelScan(Chunk_Dispenser& dispenser, size_t numThreads, Map map, Sink sink)
+    {
+        using Result = std::invoke_result_t<Map&, const Chunk_Dispenser::Ticket&>;
+        Ordered_Reassembler<Result> reassembler([&](size_t sequence, Result&& result) {
+            sink(sequence, std::move(result));
+        });
+
+        std::atomic<bool> failed{false};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+        auto fail = [&] {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+        };
+
+        auto work = [&] {
+            try
+            {
+                Chunk_Dispenser::Ticket ticket;
+                while (!failed && dispenser.next(ticket))
+                    reassembler.submit(ticket.sequence, map(ticket));
+            }
+            catch (...)
+            {
+                fail();
+            }
+        };
+
+        vector<std::thread> threads;
+        try
+        {
+            for (size_t i = 1; i < numThreads; i++)
+                threads.emplace_back(work);
+        }
+        catch (...)
+        {
+            fail();
+        }
+        work();
+        for (auto& thread : threads)
+            thread.join();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,91 @@
+#include "Chunk_Size_Controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace dna
+{
+    // How quickly old measurements are forgotten.  0.9 gives an effective window of ~10 chunks.
+    static const double FORGETTING = 0.9;
+    // How much larger the chunks get per unit of edit density (edited bases per base).
+    static const double DENSITY_WEIGHT = 10.0;
+    // The fit needs chunks of different sizes.  When the recent sizes have all been about
+    // the same we nudge the size by this factor to get a fresh data point.
+    static const double PROBE_FACTOR = 1.5;
+
+    Chunk_Size_Controller::Chunk_Size_Controller() : Chunk_Size_Controller(Limits())
+    {
+    }
+
+    Chunk_Size_Controller::Chunk_Size_Controller(const Limits& limits) :
+        limits_(limits)
+    {
+        if (limits_.minimumBytes == 0 || limits_.minimumBytes > limits_.maximumBytes)
+            throw std::invalid_argument("chunk size limits are inconsistent");
+
+        next_ = std::clamp(limits_.initialBytes, limits_.minimumBytes, limits_.maximumBytes);
+    }
+
+    size_t Chunk_Size_Controller::next() const
+    {
+        return next_;
+    }
+
+    double Chunk_Size_Controller::editDensity() const
+    {
+        return bases_ > 0 ? edits_ / bases_ : 0.0;
+    }
+
+    void Chunk_Size_Controller::record(size_t bytes, std::chrono::nanoseconds elapsed, size_t editedBases)
+    {
+        if (bytes == 0)
+            return;
+
+        double x = static_cast<double>(bytes) * static_cast<double>(bytes);
+        double y = static_cast<double>(elapsed.count());
+
+        sumW_ = sumW_ * FORGETTING + 1.0;
+        sumX_ = sumX_ * FORGETTING + x;
+        sumY_ = sumY_ * FORGETTING + y;
+        sumXX_ = sumXX_ * FORGETTING + x * x;
+        sumXY_ = sumXY_ * FORGETTING + x * y;
+
+        bases_ = bases_ * FORGETTING + static_cast<double>(bytes * 4);
+        edits_ = edits_ * FORGETTING + static_cast<double>(editedBases);
+
+        double current = static_cast<double>(next_);
+        double target;
+
+        double meanX = sumX_ / sumW_;
+        double meanY = sumY_ / sumW_;
+        double varX = sumXX_ / sumW_ - meanX * meanX;
+        if (varX <= 1e-4 * meanX * meanX)
+        {
+            // Not enough spread in the sizes to separate overhead from DP cost.
+            // The first probe goes up, after that we alternate around where we are.
+            target = (!probed_ || bytes <= lastBytes_) ? current * PROBE_FACTOR : current / PROBE_FACTOR;
+            if (target > static_cast<double>(limits_.maximumBytes))
+                target = current / PROBE_FACTOR;
+            probed_ = true;
+        }
+        else
+        {
+            double b = (sumXY_ / sumW_ - meanX * meanY) / varX;
+            double a = meanY - b * meanX;
+
+            if (b <= 0)
+                target = current * 2;       // The DP isn't measurable yet; overhead dominates.
+            else if (a <= 0)
+                target = current / 2;       // No measurable overhead; smaller is cheaper.
+            else
+                target = std::sqrt(a / b) * (1.0 + DENSITY_WEIGHT * editDensity());
+
+            // Don't let a single noisy measurement swing the size too far.
+            target = std::clamp(target, current / 2, current * 2);
+        }
+
+        lastBytes_ = bytes;
+        next_ = std::clamp(static_cast<size_t>(std::llround(target)), limits_.minimumBytes, limits_.maximumBytes);
+    }
+}
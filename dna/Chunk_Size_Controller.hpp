@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace dna
+{
+    // Chooses how many bytes the comparer reads from each stream per step.
+    //
+    // Aligning a chunk of n bases costs roughly a + b*n^2: a fixed per-chunk overhead
+    // (reading, unpacking, splicing the results together) plus the quadratic DP.
+    // Per base that is a/n + b*n, which is smallest at n = sqrt(a/b).  We fit a and b
+    // from the chunks measured so far, with exponential forgetting so that the estimate
+    // follows the data as it changes, and steer towards that optimum.
+    //
+    // Edit density shifts the target upwards.  Every chunk boundary that lands in a
+    // diverged region can split an edit into a spurious insertion/deletion pair, so
+    // highly divergent regions are worth a few more DP cycles per base.
+    class Chunk_Size_Controller
+    {
+    public:
+        struct Limits
+        {
+            size_t minimumBytes = 16;
+            size_t maximumBytes = 4096;
+            size_t initialBytes = 128;
+        };
+
+        Chunk_Size_Controller();
+        explicit Chunk_Size_Controller(const Limits& limits);
+
+        // The number of bytes to read from each stream for the next chunk.
+        size_t next() const;
+
+        // Report how long the chunk of the given size took to align and how many bases were edited.
+        void record(size_t bytes, std::chrono::nanoseconds elapsed, size_t editedBases);
+
+        double editDensity() const;
+
+    private:
+        Limits limits_;
+        size_t next_;
+        size_t lastBytes_ = 0;
+        bool probed_ = false;
+
+        // Exponentially weighted sums for the least squares fit of t = a + b*x, with x = n^2.
+        double sumW_ = 0;
+        double sumX_ = 0;
+        double sumY_ = 0;
+        double sumXX_ = 0;
+        double sumXY_ = 0;
+
+        double bases_ = 0;
+        double edits_ = 0;
+    };
+}
@@ -0,0 +1,109 @@
+#include "Cohort_Comparer.hpp"
+#include "Chromosome_Comparer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace dna
+{
+    Cohort_Comparer::Cohort_Comparer(std::span<Person> people, std::size_t tileSize,
+                                     const Comparison_Options& options) :
+        people_(people), tileSize_(tileSize), options_(options)
+    {
+        if (tileSize_ == 0)
+            throw std::invalid_argument("tile size must be positive");
+    }
+
+    void Cohort_Comparer::Compare(Work_Stealing_Pool& pool, const Callback& onPair)
+    {
+        std::mutex callbackMutex;
+        Task_Group group(pool);
+
+        // Only the tiles on and above the diagonal hold pairs with first < second.
+        for (std::size_t rowBegin = 0; rowBegin < people_.size(); rowBegin += tileSize_)
+        {
+            for (std::size_t columnBegin = rowBegin; columnBegin < people_.size(); columnBegin += tileSize_)
+            {
+                group.run([&, rowBegin, columnBegin] {
+                    compareTile(rowBegin, columnBegin, pool, onPair, callbackMutex);
+                });
+            }
+        }
+        group.wait();
+    }
+
+    vector<vector<vector<Chromosome_Comparison>>> Cohort_Comparer::CompareAll(Work_Stealing_Pool& pool)
+    {
+        vector<vector<vector<Chromosome_Comparison>>> results(people_.size());
+        for (auto& row : results)
+            row.resize(people_.size());
+
+        Compare(pool, [&](std::size_t first, std::size_t second, const vector<Chromosome_Comparison>& comparisons) {
+            results[first][second] = comparisons;
+            auto& inverse = results[second][first];
+            inverse.reserve(comparisons.size());
+            for (const auto& comparison : comparisons)
+                inverse.push_back(Invert(comparison));
+        });
+        return results;
+    }
+
+    void Cohort_Comparer::compareTile(std::size_t rowBegin, std::size_t columnBegin, Work_Stealing_Pool& pool,
+                                      const Callback& onPair, std::mutex& callbackMutex)
+    {
+        std::size_t rowEnd = std::min(rowBegin + tileSize_, people_.size());
+        std::size_t columnEnd = std::min(columnBegin + tileSize_, people_.size());
+
+        // The pairs of this tile, and what each of them has so far.
+        struct Pair
+        {
+            std::size_t first;
+            std::size_t second;
+            bool sameSex;
+            vector<Chromosome_Comparison> comparisons;
+        };
+        vector<Pair> pairs;
+        for (std::size_t i = rowBegin; i < rowEnd; i++)
+        {
+            for (std::size_t j = std::max(columnBegin, i + 1); j < columnEnd; j++)
+            {
+                bool sameSex = people_[i].IsSameSexAs(people_[j]);
+                pairs.push_back({ i, j, sameSex, vector<Chromosome_Comparison>(sameSex ? NUM_CHROMS : NUM_CHROMS-1) });
+            }
+        }
+        if (pairs.empty())
+            return;
+
+        // Chromosome by chromosome, each row fans out over its columns in the tile.
+        for (int c = 0; c < NUM_CHROMS; c++)
+        {
+            auto pair = pairs.begin();
+            while (pair != pairs.end())
+            {
+                std::size_t row = pair->first;
+                DNA_Stream query = people_[row].chromosome(c);
+                vector<DNA_Stream> targets;
+                vector<Pair*> owners;
+                for (; pair != pairs.end() && pair->first == row; ++pair)
+                {
+                    if (c == NUM_CHROMS-1 && !pair->sameSex)
+                        continue;
+                    targets.push_back(people_[pair->second].chromosome(c));
+                    owners.push_back(&*pair);
+                }
+                if (targets.empty())
+                    continue;
+
+                vector<std::reference_wrapper<DNA_Stream>> refs(targets.begin(), targets.end());
+                Fan_Out_Comparer comparer(c, query, refs, options_);
+                vector<Chromosome_Comparison> results = comparer.Compare(pool);
+                for (std::size_t k = 0; k < results.size(); k++)
+                    owners[k]->comparisons[c] = std::move(results[k]);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        for (const auto& pair : pairs)
+            onPair(pair.first, pair.second, pair.comparisons);
+    }
+}
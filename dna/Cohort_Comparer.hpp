@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+#include "Chromosome_Comparison.hpp"
+#include "Comparison_Options.hpp"
+#include "Person.hpp"
+#include "Work_Stealing_Pool.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // Compares every pair of people in a cohort.  Only one direction of each pair is
+    // computed; the other follows by inverting it.  The pairs are worked through in
+    // square tiles of the pair matrix, one chromosome at a time, so that the tile's
+    // rows and columns of that chromosome stay in cache while they are compared, and
+    // each row is read only once for the whole tile.  The options apply to every
+    // comparison, with progress counted per chromosome across all the pairs.
+    class Cohort_Comparer
+    {
+    public:
+        // Called as soon as a pair is done, with first < second and the comparisons
+        // of people[first] against people[second].  Calls are made one at a time, from
+        // whichever thread finished the pair's tile.
+        using Callback = std::function<void(std::size_t first, std::size_t second,
+                                            const vector<Chromosome_Comparison>& comparisons)>;
+
+        explicit Cohort_Comparer(std::span<Person> people, std::size_t tileSize = 8,
+                                 const Comparison_Options& options = {});
+
+        void Compare(Work_Stealing_Pool& pool, const Callback& onPair);
+
+        // Every ordered pair: result[i][j] compares people[i] against people[j], and is
+        // empty where i == j.
+        vector<vector<vector<Chromosome_Comparison>>> CompareAll(Work_Stealing_Pool& pool);
+
+    private:
+        void compareTile(std::size_t rowBegin, std::size_t columnBegin, Work_Stealing_Pool& pool,
+                         const Callback& onPair, std::mutex& callbackMutex);
+
+        std::span<Person> people_;
+        std::size_t tileSize_;
+        Comparison_Options options_;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Cancellation_Token.hpp"
+#include "Chunk_Size_Controller.hpp"
+#include "Comparison_Progress.hpp"
+#include "Memory_Budget.hpp"
+
+namespace dna
+{
+    // Knobs for a single chromosome comparison.  The defaults reproduce the plain
+    // chunk-by-chunk comparison over the streams' own chunk size.
+    struct Comparison_Options
+    {
+        // Let the comparer pick its own read granularity from the measured per-chunk
+        // cost and edit density, ignoring the streams' fixed chunk size.
+        bool adaptiveChunking = false;
+        Chunk_Size_Controller::Limits chunkLimits;
+
+        // Compare c1 against the reverse complement of c2 rather than c2 itself, to find
+        // inversions or to line up a sample that was read from the other strand.  The
+        // opposite strand is built once, in memory, so this needs in-memory chromosomes.
+        // Its telomeres read CCCTAA, so they are compared rather than skipped.
+        bool oppositeStrand = false;
+
+        // The 'A's padding out c2's last byte, as ReadChromosomeInfo() reports them.  Turning
+        // c2 around leaves them out; they would otherwise read as leading 'T's.
+        size_t oppositePadding = 0;
+
+        // Checked before every chunk.  Once it asks to stop, the comparison returns what
+        // it has so far, marked incomplete, with the point to resume from.
+        const Cancellation_Token* cancellation = nullptr;
+
+        // Bumped after every chunk, under the comparison's chromosome number.
+        Comparison_Progress* progress = nullptr;
+
+        // Reserved against before every chunk's DP workspace, and charged for the
+        // transformations found.  If the budget's policy is to fail, a chunk that doesn't
+        // fit stops the comparison as the cancellation token would, so it can be resumed
+        // once memory has been freed.  If it is to wait, the transformations are charged
+        // only while the comparison runs, and not while it waits, since nothing but the
+        // comparison itself could give them back.
+        Memory_Budget* memory = nullptr;
+
+        // Return the transformations packed, in Chromosome_Comparison::packedTransformations,
+        // rather than as a vector of Transformations.
+        bool packTransformations = false;
+    };
+}
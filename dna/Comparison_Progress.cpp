@@ -0,0 +1,134 @@
+#include "Comparison_Progress.hpp"
+
+#include <stdexcept>
+
+namespace dna
+{
+    Comparison_Progress::Comparison_Progress(size_t chromosomes) :
+        counters_(std::make_unique<Counters[]>(chromosomes)),
+        size_(chromosomes)
+    {
+    }
+
+    size_t Comparison_Progress::chromosomes() const
+    {
+        return size_;
+    }
+
+    Comparison_Progress::Counters* Comparison_Progress::counters(int chromosome) const
+    {
+        if (chromosome < 0 || static_cast<size_t>(chromosome) >= size_)
+            return nullptr;
+        return &counters_[chromosome];
+    }
+
+    void Comparison_Progress::record(int chromosome, size_t c1Bases, size_t c2Bases, size_t transformations)
+    {
+        Counters* c = counters(chromosome);
+        if (c == nullptr)
+            return;
+
+        Clock::rep now = Clock::now().time_since_epoch().count();
+        Clock::rep unset = 0;
+        c->started.compare_exchange_strong(unset, now, std::memory_order_relaxed);
+        c->c1Bases.fetch_add(c1Bases, std::memory_order_relaxed);
+        c->c2Bases.fetch_add(c2Bases, std::memory_order_relaxed);
+        c->chunks.fetch_add(1, std::memory_order_relaxed);
+        c->transformations.fetch_add(transformations, std::memory_order_relaxed);
+        c->updated.store(now, std::memory_order_relaxed);
+    }
+
+    void Comparison_Progress::finish(int chromosome)
+    {
+        Counters* c = counters(chromosome);
+        if (c != nullptr)
+            c->finished.store(true, std::memory_order_relaxed);
+    }
+
+    Progress_Snapshot Comparison_Progress::snapshot(int chromosome) const
+    {
+        const Counters* c = counters(chromosome);
+        if (c == nullptr)
+            throw std::invalid_argument("chromosome is not being tracked");
+
+        Progress_Snapshot s;
+        s.chromosome = chromosome;
+        s.c1Bases = c->c1Bases.load(std::memory_order_relaxed);
+        s.c2Bases = c->c2Bases.load(std::memory_order_relaxed);
+        s.chunks = c->chunks.load(std::memory_order_relaxed);
+        s.transformations = c->transformations.load(std::memory_order_relaxed);
+        s.finished = c->finished.load(std::memory_order_relaxed);
+
+        Clock::rep started = c->started.load(std::memory_order_relaxed);
+        if (started != 0)
+        {
+            // A finished comparison's clock stops at its last chunk.
+            Clock::rep end = s.finished ? c->updated.load(std::memory_order_relaxed)
+                                        : Clock::now().time_since_epoch().count();
+            s.seconds = std::chrono::duration<double>(Clock::duration(end - started)).count();
+            if (s.seconds > 0)
+                s.basesPerSecond = s.c1Bases / s.seconds;
+        }
+        return s;
+    }
+
+    vector<Progress_Snapshot> Comparison_Progress::snapshot() const
+    {
+        vector<Progress_Snapshot> snapshots;
+        snapshots.reserve(size_);
+        for (size_t i = 0; i < size_; i++)
+            snapshots.push_back(snapshot(static_cast<int>(i)));
+        return snapshots;
+    }
+
+    Progress_Reporter::Progress_Reporter(const Comparison_Progress& progress, std::chrono::milliseconds interval,
+                                         Callback callback) :
+        progress_(progress),
+        interval_(interval),
+        callback_(std::move(callback)),
+        previous_(progress.snapshot()),
+        previousTime_(Comparison_Progress::Clock::now())
+    {
+        if (interval_.count() <= 0)
+            throw std::invalid_argument("reporting interval must be positive");
+
+        thread_ = std::thread([this] { run(); });
+    }
+
+    Progress_Reporter::~Progress_Reporter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    void Progress_Reporter::run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!wake_.wait_for(lock, interval_, [this] { return stopping_; }))
+            report();
+
+        // One last report, so that the final state is always seen.
+        report();
+    }
+
+    void Progress_Reporter::report()
+    {
+        auto now = Comparison_Progress::Clock::now();
+        double elapsed = std::chrono::duration<double>(now - previousTime_).count();
+
+        vector<Progress_Snapshot> current = progress_.snapshot();
+        for (size_t i = 0; i < current.size(); i++)
+        {
+            if (!current[i].finished && elapsed > 0)
+                current[i].basesPerSecond = (current[i].c1Bases - previous_[i].c1Bases) / elapsed;
+        }
+
+        callback_(current);
+        previous_ = std::move(current);
+        previousTime_ = now;
+    }
+}
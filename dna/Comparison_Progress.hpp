@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+namespace dna
+{
+    // How far one chromosome comparison has got.
+    struct Progress_Snapshot
+    {
+        int chromosome = 0;
+        size_t c1Bases = 0;             // bases consumed from each chromosome
+        size_t c2Bases = 0;
+        size_t chunks = 0;              // chunk pairs aligned
+        size_t transformations = 0;     // transformations emitted
+        bool finished = false;
+        double seconds = 0;             // since the comparison's first chunk
+        double basesPerSecond = 0;      // of the first chromosome
+    };
+
+    // Live counters for the chromosomes of a comparison.  The comparers bump them with
+    // relaxed atomic adds as each chunk is aligned, and any thread can take a snapshot
+    // at any time without locking.
+    class Comparison_Progress
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit Comparison_Progress(size_t chromosomes);
+
+        size_t chromosomes() const;
+
+        // Chromosome numbers beyond the ones being tracked are ignored.
+        void record(int chromosome, size_t c1Bases, size_t c2Bases, size_t transformations);
+        void finish(int chromosome);
+
+        // Throughput here is the average since the chromosome's first chunk.
+        Progress_Snapshot snapshot(int chromosome) const;
+        vector<Progress_Snapshot> snapshot() const;
+
+    private:
+        // One cache line each, so that chromosomes compared on different cores don't
+        // fight over their counters.
+        struct alignas(64) Counters
+        {
+            std::atomic<size_t> c1Bases{0};
+            std::atomic<size_t> c2Bases{0};
+            std::atomic<size_t> chunks{0};
+            std::atomic<size_t> transformations{0};
+            std::atomic<bool> finished{false};
+            std::atomic<Clock::rep> started{0};
+            std::atomic<Clock::rep> updated{0};
+        };
+
+        Counters* counters(int chromosome) const;
+
+        std::unique_ptr<Counters[]> counters_;
+        size_t size_;
+    };
+
+    // Calls back with snapshots of every chromosome at a fixed interval, from a thread
+    // of its own, until it is destroyed.  Throughput is measured over each interval,
+    // so a chromosome that has stalled shows up straight away.
+    class Progress_Reporter
+    {
+    public:
+        using Callback = std::function<void(const vector<Progress_Snapshot>&)>;
+
+        Progress_Reporter(const Comparison_Progress& progress, std::chrono::milliseconds interval, Callback callback);
+        ~Progress_Reporter();
+
+        Progress_Reporter(const Progress_Reporter&) = delete;
+        Progress_Reporter& operator=(const Progress_Reporter&) = delete;
+
+    private:
+        void run();
+        void report();
+
+        const Comparison_Progress& progress_;
+        std::chrono::milliseconds interval_;
+        Callback callback_;
+        vector<Progress_Snapshot> previous_;
+        Comparison_Progress::Clock::time_point previousTime_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+        std::thread thread_;
+    };
+}
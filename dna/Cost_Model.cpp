@@ -0,0 +1,40 @@
+#include "Cost_Model.hpp"
+#include "base.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace dna
+{
+    Cost_Model::Cost_Model(const Comparison_Options& options) :
+        adaptive_(options.adaptiveChunking), adaptiveBytes_(options.chunkLimits.initialBytes)
+    {
+    }
+
+    double Cost_Model::estimate(size_t c1Bytes, size_t c2Bytes, size_t chunkBytes) const
+    {
+        // With adaptive chunking the chunk size wanders, but it starts from the initial
+        // size and settles near it for typical edit densities.
+        double chunkBases = double(adaptive_ ? adaptiveBytes_ : chunkBytes) * packed_size::value;
+        double bases = double(std::max(c1Bytes, c2Bytes)) * packed_size::value;
+        return bases * std::max(chunkBases, 1.0);
+    }
+
+    size_t Cost_Model::segmentBytes(size_t bytes, double cost, double target, size_t minimumBytes) const
+    {
+        if (cost <= target || target <= 0)
+            return std::max(bytes, minimumBytes);
+
+        size_t pieces = static_cast<size_t>(std::ceil(cost / target));
+        return std::max((bytes + pieces - 1) / pieces, minimumBytes);
+    }
+
+    vector<size_t> LongestFirst(const vector<double>& costs)
+    {
+        vector<size_t> order(costs.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return costs[a] > costs[b]; });
+        return order;
+    }
+}
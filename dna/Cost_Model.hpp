@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Comparison_Options.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // Estimates the work in comparing two chromosomes, in DP cells.  The aligner fills a
+    // table of chunk × chunk bases for every pair of chunks, so a chromosome costs about
+    // its length in bases times the chunk length in bases: the chunk size matters as much
+    // as the chromosome's.
+    class Cost_Model
+    {
+    public:
+        explicit Cost_Model(const Comparison_Options& options = {});
+
+        // The cost of comparing [begin, end) of two chromosomes read in chunks of the
+        // given size.  The longer of the two sets the number of chunks.
+        double estimate(size_t c1Bytes, size_t c2Bytes, size_t chunkBytes) const;
+
+        // The size of segment to cut a chromosome of the given cost into so that no
+        // piece costs more than the target, but never smaller than the minimum.
+        size_t segmentBytes(size_t bytes, double cost, double target, size_t minimumBytes) const;
+
+    private:
+        bool adaptive_;
+        size_t adaptiveBytes_;
+    };
+
+    // The order in which to hand out jobs of the given costs for longest-processing-time
+    // first scheduling: the most expensive first, ties in their original order.
+    vector<size_t> LongestFirst(const vector<double>& costs);
+}
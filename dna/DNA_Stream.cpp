@@ -1,8 +1,15 @@
 #include "DNA_Stream.hpp"
 
+#include <system_error>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace dna
 {
-    DNA_Stream::DNA_Stream() : offset_(0), chunksize_(1) {
+    DNA_Stream::DNA_Stream() : data_(std::make_shared<Genome_Buffer>()), chunksize_(1), offset_(0) {
     }
 
     DNA_Stream::DNA_Stream(const DNA_Stream& other) {
@@ -12,15 +19,49 @@ namespace dna
     }
 
     DNA_Stream::DNA_Stream(DNA_Stream&& other) noexcept {
-        data_ = std::move(other.data_);
+        data_ = other.data_;
         chunksize_ = other.chunksize_;
         offset_ = other.offset_.exchange(0);
     }
 
-    DNA_Stream::DNA_Stream(std::vector<std::byte> data, std::size_t chunksize) {
-        data_ = std::move(data);
-        chunksize_ = chunksize;
-        offset_ = 0;
+    DNA_Stream::DNA_Stream(const std::vector<std::byte>& data, std::size_t chunksize, Allocation_Policy policy) :
+        data_(std::make_shared<Genome_Buffer>(data.data(), data.size(), policy)), chunksize_(chunksize), offset_(0) {
+    }
+
+    DNA_Stream::DNA_Stream(Genome_Buffer data, std::size_t chunksize) :
+        data_(std::make_shared<Genome_Buffer>(std::move(data))), chunksize_(chunksize), offset_(0) {
+    }
+
+    DNA_Stream DNA_Stream::FromFile(const std::string& path, std::size_t chunksize, Allocation_Policy policy) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "unable to open " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "unable to stat " + path);
+        }
+
+        // Read straight into the final buffer.  Its pages are first touched here, by the
+        // loading thread, which is also what places them on huge pages when requested.
+        Genome_Buffer buffer(static_cast<size_t>(st.st_size), policy);
+        size_t got = 0;
+        while (got < buffer.size()) {
+            ssize_t n = ::pread(fd, buffer.data() + got, buffer.size() - got, static_cast<off_t>(got));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0) {
+                int error = n < 0 ? errno : EIO;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "unable to read " + path);
+            }
+            got += static_cast<size_t>(n);
+        }
+        ::close(fd);
+
+        return DNA_Stream(std::move(buffer), chunksize);
     }
 
     DNA_Stream& DNA_Stream::operator=(const DNA_Stream& other) {
@@ -34,7 +75,7 @@ namespace dna
 
     DNA_Stream& DNA_Stream::operator=(DNA_Stream&& other) noexcept {
         if (&other != this) {
-            data_ = std::move(other.data_);
+            data_ = other.data_;
             chunksize_ = other.chunksize_;
             offset_ = other.offset_.exchange(0);
         }
@@ -44,29 +85,48 @@ namespace dna
     // Set the offset position in the stream to the given offset position.
     // NB: This offset is an absolute position, not relative to the current position.
     void DNA_Stream::seek(size_t offset) {
-        offset_.store(std::min(std::max(offset, size_t(0)), data_.size()));
+        offset_.store(std::min(std::max(offset, size_t(0)), data_->size()));
     }
 
     size_t DNA_Stream::size() const {
-        return data_.size();
+        return data_->size();
+    }
+
+    size_t DNA_Stream::chunkSize() const {
+        return chunksize_;
     }
 
     sequence_buffer<byte_view> DNA_Stream::read() {
+        return read(chunksize_);
+    }
+
+    // Read up to maxBytes, regardless of the stream's own chunk size.
+    sequence_buffer<byte_view> DNA_Stream::read(size_t maxBytes) {
         auto offset = offset_.load(std::memory_order_consume);
         while (true)
         {
-            auto len = std::min(chunksize_, data_.size() - offset_);
+            auto len = std::min(maxBytes, data_->size() - offset_);
             if (len == 0)
                 return byte_view(nullptr, 0);
 
             if (offset_.compare_exchange_weak(offset, offset + len, std::memory_order_release))
-                return byte_view(data_.data() + offset, len);
+                return byte_view(data_->data() + offset, len);
         }
     }
 
+    sequence_buffer<byte_view> DNA_Stream::view(size_t offset, size_t length) const {
+        offset = std::min(offset, data_->size());
+        length = std::min(length, data_->size() - offset);
+        return byte_view(data_->data() + offset, length);
+    }
+
+    bool DNA_Stream::bindToNode(int nodeId) const {
+        return data_->bindToNode(nodeId);
+    }
+
     bool DNA_Stream::atEnd() const
     {
-        return offset_ == data_.size();
+        return offset_ == data_->size();
     }
 
     void DNA_Stream::advanceToEnd()
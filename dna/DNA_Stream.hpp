@@ -4,14 +4,19 @@
 #include <string_view>
 #include <vector>
 #include <atomic>
+#include <memory>
+#include <string>
 #include "sequence_buffer.hpp"
 #include "byte_view.hpp"
+#include "Genome_Buffer.hpp"
 
 namespace dna
 {
+    // Copies of a stream share its (immutable) data and only get their own offset,
+    // so handing each worker its own cursor over a chromosome is cheap.
     class DNA_Stream
     {
-        std::vector<std::byte> data_;
+        std::shared_ptr<const Genome_Buffer> data_;
         std::size_t chunksize_;
         std::atomic<size_t> offset_;
     public:
@@ -19,14 +24,29 @@ namespace dna
         DNA_Stream();
         DNA_Stream(const DNA_Stream& other);
         DNA_Stream(DNA_Stream&& other) noexcept;
-        DNA_Stream(std::vector<std::byte> data, std::size_t chunksize = 512);
+        DNA_Stream(const std::vector<std::byte>& data, std::size_t chunksize = 512,
+                   Allocation_Policy policy = Allocation_Policy::cache_aligned);
+        DNA_Stream(Genome_Buffer data, std::size_t chunksize = 512);
+
+        // Load a packed chromosome file straight into a buffer allocated with the given policy.
+        static DNA_Stream FromFile(const std::string& path, std::size_t chunksize = 512,
+                                   Allocation_Policy policy = Allocation_Policy::cache_aligned);
 
         DNA_Stream& operator=(const DNA_Stream& other);
         DNA_Stream& operator=(DNA_Stream&& other) noexcept;
 
         void seek(size_t offset);
         size_t size() const;
+        size_t chunkSize() const;
         sequence_buffer<byte_view> read();
+        sequence_buffer<byte_view> read(size_t maxBytes);
+
+        // Positional access that leaves the stream's own offset alone, so any number
+        // of threads can look at disjoint (or overlapping) parts of the data at once.
+        sequence_buffer<byte_view> view(size_t offset, size_t length) const;
+
+        // Place the data on a NUMA node.  Affects every copy of the stream.
+        bool bindToNode(int nodeId) const;
 
         bool atEnd() const;
         void advanceToEnd();
@@ -0,0 +1,169 @@
+#include "File_Stream.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dna
+{
+    File_Stream::File_Stream(const string& path, size_t chunksize, size_t queueDepth, Async_Backend backend) :
+        chunksize_(chunksize), queueDepth_(queueDepth), backend_(backend)
+    {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "unable to open " + path);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+        {
+            int error = errno;
+            ::close(fd_);
+            throw std::system_error(error, std::generic_category(), "unable to stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        // We read the file front to back.  Let the kernel know so that its own
+        // readahead doesn't fight with ours.
+        ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    File_Stream::File_Stream(File_Stream&& other) noexcept :
+        fd_(other.fd_), size_(other.size_), chunksize_(other.chunksize_), queueDepth_(other.queueDepth_),
+        backend_(other.backend_), offset_(other.offset_), reader_(std::move(other.reader_)),
+        current_(std::move(other.current_)), consumed_(other.consumed_), staging_(std::move(other.staging_))
+    {
+        other.fd_ = -1;
+        other.size_ = 0;
+        other.offset_ = 0;
+    }
+
+    File_Stream::~File_Stream()
+    {
+        // The reader may still have reads in flight against the descriptor.
+        reader_.reset();
+        if (fd_ >= 0)
+            ::close(fd_);
+    }
+
+    File_Stream& File_Stream::operator=(File_Stream&& other) noexcept
+    {
+        if (&other != this)
+        {
+            reader_.reset();
+            if (fd_ >= 0)
+                ::close(fd_);
+
+            fd_ = other.fd_;
+            size_ = other.size_;
+            chunksize_ = other.chunksize_;
+            queueDepth_ = other.queueDepth_;
+            backend_ = other.backend_;
+            offset_ = other.offset_;
+            reader_ = std::move(other.reader_);
+            current_ = std::move(other.current_);
+            consumed_ = other.consumed_;
+            staging_ = std::move(other.staging_);
+
+            other.fd_ = -1;
+            other.size_ = 0;
+            other.offset_ = 0;
+        }
+        return *this;
+    }
+
+    // Set the offset position in the stream to the given offset position.
+    // NB: This offset is an absolute position, not relative to the current position.
+    void File_Stream::seek(size_t offset)
+    {
+        offset = std::min(offset, size_);
+        if (offset == offset_)
+            return;
+
+        // Anything already in flight is for the wrong part of the file now.
+        if (reader_)
+            reader_->restart(offset);
+        offset_ = offset;
+        current_.data.clear();
+        consumed_ = 0;
+    }
+
+    size_t File_Stream::size() const
+    {
+        return size_;
+    }
+
+    size_t File_Stream::chunkSize() const
+    {
+        return chunksize_;
+    }
+
+    sequence_buffer<byte_view> File_Stream::read()
+    {
+        return read(chunksize_);
+    }
+
+    // Read up to maxBytes.  Reads that fit in the chunk at hand are served straight from
+    // the read-ahead buffer; larger ones are gathered into a staging buffer.
+    sequence_buffer<byte_view> File_Stream::read(size_t maxBytes)
+    {
+        if (offset_ >= size_ || maxBytes == 0 || !nextChunk())
+            return byte_view(nullptr, 0);
+
+        size_t available = current_.data.size() - consumed_;
+        if (maxBytes <= available)
+        {
+            const std::byte* start = current_.data.data() + consumed_;
+            consumed_ += maxBytes;
+            offset_ += maxBytes;
+            return byte_view(start, maxBytes);
+        }
+
+        staging_.clear();
+        while (staging_.size() < maxBytes && nextChunk())
+        {
+            size_t take = std::min(maxBytes - staging_.size(), current_.data.size() - consumed_);
+            auto start = current_.data.begin() + static_cast<long>(consumed_);
+            staging_.insert(staging_.end(), start, start + static_cast<long>(take));
+            consumed_ += take;
+            offset_ += take;
+        }
+        return byte_view(staging_.data(), staging_.size());
+    }
+
+    bool File_Stream::atEnd() const
+    {
+        return offset_ == size_;
+    }
+
+    void File_Stream::advanceToEnd()
+    {
+        seek(size());
+    }
+
+    bool File_Stream::usingIoUring()
+    {
+        return reader().usingIoUring();
+    }
+
+    // Make sure there is something left in current_, fetching the next chunk if necessary.
+    bool File_Stream::nextChunk()
+    {
+        if (consumed_ < current_.data.size())
+            return true;
+        if (offset_ >= size_ || !reader().next(current_))
+            return false;
+        consumed_ = 0;
+        return !current_.data.empty();
+    }
+
+    Async_Chunk_Reader& File_Stream::reader()
+    {
+        if (!reader_)
+            reader_ = std::make_unique<Async_Chunk_Reader>(fd_, offset_, size_, chunksize_, queueDepth_, backend_);
+        return *reader_;
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "sequence_buffer.hpp"
+#include "byte_view.hpp"
+#include "Async_Chunk_Reader.hpp"
+
+using std::string;
+
+namespace dna
+{
+    // A helix stream over a packed chromosome file.  Chunks are read ahead
+    // asynchronously, so the comparison loop never waits on a single pread.
+    // The buffer returned by read() is only valid until the next read() or seek().
+    class File_Stream
+    {
+        int fd_ = -1;
+        size_t size_ = 0;
+        size_t chunksize_;
+        size_t queueDepth_;
+        Async_Backend backend_;
+        size_t offset_ = 0;
+        std::unique_ptr<Async_Chunk_Reader> reader_;
+        Async_Chunk_Reader::Chunk current_;
+        size_t consumed_ = 0;                       // bytes of current_ already handed out
+        Async_Chunk_Reader::Chunk_Buffer staging_;  // for reads that straddle two chunks
+
+    public:
+        File_Stream(const string& path, size_t chunksize = 512, size_t queueDepth = 8,
+                    Async_Backend backend = Async_Backend::automatic);
+        File_Stream(File_Stream&& other) noexcept;
+        ~File_Stream();
+
+        File_Stream(const File_Stream&) = delete;
+        File_Stream& operator=(const File_Stream&) = delete;
+        File_Stream& operator=(File_Stream&& other) noexcept;
+
+        void seek(size_t offset);
+        size_t size() const;
+        size_t chunkSize() const;
+        sequence_buffer<byte_view> read();
+        sequence_buffer<byte_view> read(size_t maxBytes);
+
+        bool atEnd() const;
+        void advanceToEnd();
+
+        bool usingIoUring();
+
+    private:
+        Async_Chunk_Reader& reader();
+        bool nextChunk();
+    };
+}
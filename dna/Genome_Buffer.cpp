@@ -0,0 +1,157 @@
+#include "Genome_Buffer.hpp"
+#include "Numa_Topology.hpp"
+
+#include <cstring>
+#include <cstdint>
+#include <utility>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << 26)
+#endif
+
+namespace dna
+{
+    static size_t RoundUp(size_t value, size_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    Genome_Buffer::Genome_Buffer(size_t size, Allocation_Policy policy)
+    {
+        allocate(size, policy);
+    }
+
+    Genome_Buffer::Genome_Buffer(const std::byte* data, size_t size, Allocation_Policy policy)
+    {
+        allocate(size, policy);
+        if (size > 0)
+            std::memcpy(data_, data, size);
+    }
+
+    Genome_Buffer::Genome_Buffer(const Genome_Buffer& other)
+    {
+        allocate(other.size_, other.policy_);
+        if (size_ > 0)
+            std::memcpy(data_, other.data_, size_);
+    }
+
+    Genome_Buffer::Genome_Buffer(Genome_Buffer&& other) noexcept :
+        data_(other.data_), size_(other.size_), mapped_(other.mapped_), policy_(other.policy_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = 0;
+    }
+
+    Genome_Buffer::~Genome_Buffer()
+    {
+        release();
+    }
+
+    Genome_Buffer& Genome_Buffer::operator=(const Genome_Buffer& other)
+    {
+        if (&other != this)
+        {
+            Genome_Buffer copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    Genome_Buffer& Genome_Buffer::operator=(Genome_Buffer&& other) noexcept
+    {
+        if (&other != this)
+        {
+            release();
+            data_ = other.data_;
+            size_ = other.size_;
+            mapped_ = other.mapped_;
+            policy_ = other.policy_;
+            other.data_ = nullptr;
+            other.size_ = 0;
+            other.mapped_ = 0;
+        }
+        return *this;
+    }
+
+    bool Genome_Buffer::bindToNode(int nodeId) const
+    {
+        return BindMemoryToNode(data_, size_, nodeId);
+    }
+
+    void Genome_Buffer::allocate(size_t size, Allocation_Policy policy)
+    {
+        size_ = size;
+        if (size == 0)
+            return;
+
+        // Huge pages only pay off once the buffer spans at least one of them.
+        if (size < HUGE_PAGE_SIZE)
+            policy = Allocation_Policy::cache_aligned;
+
+        if (policy == Allocation_Policy::huge_tlb)
+        {
+            size_t length = RoundUp(size, HUGE_PAGE_SIZE);
+            void* p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                data_ = static_cast<std::byte*>(p);
+                mapped_ = length;
+                policy_ = Allocation_Policy::huge_tlb;
+                return;
+            }
+
+            // No reserved huge pages.  Transparent huge pages are the next best thing.
+            policy = Allocation_Policy::transparent_huge_pages;
+        }
+
+        if (policy == Allocation_Policy::transparent_huge_pages)
+        {
+            // Over-allocate so that we can trim the mapping down to a 2 MB aligned range.
+            // The kernel can only back aligned 2 MB ranges with a huge page.
+            size_t length = RoundUp(size, HUGE_PAGE_SIZE);
+            void* p = ::mmap(nullptr, length + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                auto raw = reinterpret_cast<std::uintptr_t>(p);
+                auto aligned = RoundUp(raw, HUGE_PAGE_SIZE);
+                size_t head = aligned - raw;
+                size_t tail = HUGE_PAGE_SIZE - head;
+                if (head > 0)
+                    ::munmap(p, head);
+                if (tail > 0)
+                    ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+
+                ::madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+                data_ = reinterpret_cast<std::byte*>(aligned);
+                mapped_ = length;
+                policy_ = Allocation_Policy::transparent_huge_pages;
+                return;
+            }
+        }
+
+        size_t length = RoundUp(size, CACHE_LINE_SIZE);
+        data_ = static_cast<std::byte*>(::operator new(length, std::align_val_t(CACHE_LINE_SIZE)));
+        std::memset(data_ + size, 0, length - size);
+        mapped_ = 0;
+        policy_ = Allocation_Policy::cache_aligned;
+    }
+
+    void Genome_Buffer::release() noexcept
+    {
+        if (data_ == nullptr)
+            return;
+
+        if (mapped_ > 0)
+            ::munmap(data_, mapped_);
+        else
+            ::operator delete(data_, std::align_val_t(CACHE_LINE_SIZE));
+
+        data_ = nullptr;
+        size_ = 0;
+        mapped_ = 0;
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include "byte_view.hpp"
+
+namespace dna
+{
+    enum class Allocation_Policy
+    {
+        cache_aligned,              // 64-byte aligned, padded to a whole cache line
+        transparent_huge_pages,     // 2 MB aligned and madvise()d for transparent huge pages
+        huge_tlb                    // explicit MAP_HUGETLB pages, falling back to transparent huge pages
+    };
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // Storage for packed chromosome data.  The allocation always starts on a cache
+    // line and is zero padded to the next cache line, so SIMD kernels can issue whole
+    // aligned loads up to the end without splitting or running off the allocation.
+    // Large chromosomes can ask for huge pages, which turns the ~15k 4K pages of a
+    // 249 Mbp chromosome into ~30 huge pages during a sequential scan.
+    class Genome_Buffer
+    {
+        std::byte* data_ = nullptr;
+        size_t size_ = 0;
+        size_t mapped_ = 0;         // non-zero when data_ came from mmap()
+        Allocation_Policy policy_ = Allocation_Policy::cache_aligned;
+
+    public:
+        Genome_Buffer() = default;
+        explicit Genome_Buffer(size_t size, Allocation_Policy policy = Allocation_Policy::cache_aligned);
+        Genome_Buffer(const std::byte* data, size_t size, Allocation_Policy policy = Allocation_Policy::cache_aligned);
+        Genome_Buffer(const Genome_Buffer& other);
+        Genome_Buffer(Genome_Buffer&& other) noexcept;
+        ~Genome_Buffer();
+
+        Genome_Buffer& operator=(const Genome_Buffer& other);
+        Genome_Buffer& operator=(Genome_Buffer&& other) noexcept;
+
+        std::byte* data() noexcept { return data_; }
+        const std::byte* data() const noexcept { return data_; }
+        size_t size() const noexcept { return size_; }
+        byte_view view() const noexcept { return byte_view(data_, size_); }
+
+        // The policy that was actually honoured.  Huge pages are only used for
+        // buffers of at least one huge page, and MAP_HUGETLB needs pages reserved
+        // by the administrator, so this can be weaker than what was requested.
+        Allocation_Policy policy() const noexcept { return policy_; }
+
+        // Move the buffer's pages to a NUMA node (by kernel number) and keep them there.
+        // Only the placement changes, never the contents.
+        bool bindToNode(int nodeId) const;
+
+    private:
+        void allocate(size_t size, Allocation_Policy policy);
+        void release() noexcept;
+    };
+
+    // A standard allocator for cache line aligned containers, used for the
+    // smaller transient chunk buffers.
+    template<typename T, size_t Alignment = CACHE_LINE_SIZE>
+    struct aligned_allocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Alignment>;
+        };
+
+        constexpr aligned_allocator() noexcept = default;
+
+        template<typename U>
+        constexpr aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+        { }
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* p, size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+        template<typename U>
+        constexpr bool operator==(const aligned_allocator<U, Alignment>&) const noexcept
+        {
+            return true;
+        }
+    };
+}
@@ -0,0 +1,191 @@
+#include "Genome_Importer.hpp"
+#include "Base_Encoder.hpp"
+#include "base.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dna
+{
+namespace
+{
+    // Owns a file descriptor, so that a failed import doesn't leak them.
+    class File_Descriptor
+    {
+    public:
+        File_Descriptor(const string& path, int flags, mode_t mode = 0) : path_(path)
+        {
+            fd_ = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+            if (fd_ < 0)
+                throw std::system_error(errno, std::generic_category(), "unable to open " + path);
+        }
+        ~File_Descriptor()
+        {
+            if (fd_ >= 0)
+                ::close(fd_);
+        }
+
+        File_Descriptor(const File_Descriptor&) = delete;
+        File_Descriptor& operator=(const File_Descriptor&) = delete;
+
+        size_t size() const
+        {
+            struct stat st;
+            if (::fstat(fd_, &st) != 0)
+                throw std::system_error(errno, std::generic_category(), "unable to stat " + path_);
+            return static_cast<size_t>(st.st_size);
+        }
+
+        void resize(size_t size) const
+        {
+            if (::ftruncate(fd_, static_cast<off_t>(size)) != 0)
+                throw std::system_error(errno, std::generic_category(), "unable to size " + path_);
+        }
+
+        void readAt(char* data, size_t length, size_t offset) const
+        {
+            for (size_t got = 0; got < length; )
+            {
+                ssize_t n = ::pread(fd_, data + got, length - got, static_cast<off_t>(offset + got));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw std::system_error(n < 0 ? errno : EIO, std::generic_category(), "unable to read " + path_);
+                got += static_cast<size_t>(n);
+            }
+        }
+
+        void writeAt(const std::byte* data, size_t length, size_t offset) const
+        {
+            for (size_t put = 0; put < length; )
+            {
+                ssize_t n = ::pwrite(fd_, data + put, length - put, static_cast<off_t>(offset + put));
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    throw std::system_error(n < 0 ? errno : EIO, std::generic_category(), "unable to write " + path_);
+                put += static_cast<size_t>(n);
+            }
+        }
+
+    private:
+        string path_;
+        int fd_ = -1;
+    };
+
+    // One chromosome being imported.
+    struct Import
+    {
+        File_Descriptor text;
+        File_Descriptor packed;
+        size_t bases;
+
+        Import(const string& textPath, const string& packedPath) :
+            text(textPath, O_RDONLY), packed(packedPath, O_WRONLY | O_CREAT | O_TRUNC, 0644), bases(text.size())
+        {
+            // Leave off the line break, if there is one.
+            char last;
+            while (bases > 0)
+            {
+                text.readAt(&last, 1, bases - 1);
+                if (last != '\n' && last != '\r')
+                    break;
+                bases--;
+            }
+            packed.resize((bases + packed_size::value - 1) / packed_size::value);
+        }
+    };
+}
+
+    string MetadataPath(const string& packedPath)
+    {
+        return packedPath + ".meta";
+    }
+
+    Packed_Chromosome_Info ReadChromosomeInfo(const string& packedPath)
+    {
+        std::ifstream in(MetadataPath(packedPath));
+        if (!in)
+            throw std::invalid_argument("no metadata for " + packedPath);
+
+        Packed_Chromosome_Info info;
+        string key;
+        size_t value;
+        while (in >> key >> value)
+        {
+            if (key == "bases")
+                info.bases = value;
+            else if (key == "padding")
+                info.padding = value;
+        }
+        if (info.padding >= packed_size::value ||
+            (info.bases + info.padding) % packed_size::value != 0)
+            throw std::invalid_argument("inconsistent metadata for " + packedPath);
+        return info;
+    }
+
+    void WriteChromosomeInfo(const string& packedPath, const Packed_Chromosome_Info& info)
+    {
+        std::ofstream out(MetadataPath(packedPath), std::ios::trunc);
+        out << "bases " << info.bases << "\n"
+            << "padding " << info.padding << "\n";
+        if (!out)
+            throw std::invalid_argument("unable to write metadata for " + packedPath);
+    }
+
+    vector<Packed_Chromosome_Info> ImportChromosomes(const vector<string>& textPaths, const vector<string>& packedPaths,
+                                                     Work_Stealing_Pool& pool, size_t segmentBases)
+    {
+        if (textPaths.size() != packedPaths.size())
+            throw std::invalid_argument("every text file needs a packed file");
+
+        // Segments start on a byte boundary, so each writes whole bytes of its own.
+        segmentBases = std::max(segmentBases / packed_size::value, size_t(1)) * packed_size::value;
+
+        vector<std::unique_ptr<Import>> imports;
+        for (size_t i = 0; i < textPaths.size(); i++)
+            imports.push_back(std::make_unique<Import>(textPaths[i], packedPaths[i]));
+
+        Task_Group group(pool);
+        for (auto& import : imports)
+        {
+            for (size_t begin = 0; begin < import->bases; begin += segmentBases)
+            {
+                group.run([&import = *import, begin, segmentBases] {
+                    size_t length = std::min(segmentBases, import.bases - begin);
+                    string text(length, 'A');
+                    import.text.readAt(text.data(), length, begin);
+
+                    vector<std::byte> packed = EncodeBases(text);
+                    import.packed.writeAt(packed.data(), packed.size(), begin / packed_size::value);
+                });
+            }
+        }
+        group.wait();
+
+        vector<Packed_Chromosome_Info> infos;
+        for (size_t i = 0; i < imports.size(); i++)
+        {
+            Packed_Chromosome_Info info;
+            info.bases = imports[i]->bases;
+            info.padding = (packed_size::value - info.bases % packed_size::value) % packed_size::value;
+            WriteChromosomeInfo(packedPaths[i], info);
+            infos.push_back(info);
+        }
+        return infos;
+    }
+
+    Packed_Chromosome_Info ImportChromosome(const string& textPath, const string& packedPath,
+                                            Work_Stealing_Pool& pool, size_t segmentBases)
+    {
+        return ImportChromosomes({ textPath }, { packedPath }, pool, segmentBases).front();
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Work_Stealing_Pool.hpp"
+
+using std::string;
+using std::vector;
+
+namespace dna
+{
+    // What the importer records next to each packed chromosome file.  The packed file
+    // itself is nothing but the bases, four to a byte, so DNA_Stream::FromFile() and
+    // File_Stream read it as it is; this says how much of its last byte is real.
+    struct Packed_Chromosome_Info
+    {
+        size_t bases = 0;       // the chromosome's length in bases
+        size_t padding = 0;     // 'A's added to fill the last byte, zero to three
+    };
+
+    // The metadata file that goes with a packed chromosome file: the same path plus ".meta".
+    string MetadataPath(const string& packedPath);
+    Packed_Chromosome_Info ReadChromosomeInfo(const string& packedPath);
+    void WriteChromosomeInfo(const string& packedPath, const Packed_Chromosome_Info& info);
+
+    // Bases per import segment: a few milliseconds of work, and enough segments in
+    // chromosome 21 to keep a large node busy.
+    static constexpr size_t DEFAULT_IMPORT_SEGMENT = 4 * 1024 * 1024;
+
+    // Pack a chromosome held as one line of ACGT text, as ConvertToData() would, into
+    // a packed file and its metadata.  The text is cut into segments that are read,
+    // encoded and written in place by the pool's workers, so no thread ever holds more
+    // than a segment of it.  A trailing line break is ignored.
+    Packed_Chromosome_Info ImportChromosome(const string& textPath, const string& packedPath,
+                                            Work_Stealing_Pool& pool, size_t segmentBases = DEFAULT_IMPORT_SEGMENT);
+
+    // A whole person at once: packedPaths[i] from textPaths[i], with the segments of
+    // every chromosome sharing the pool.
+    vector<Packed_Chromosome_Info> ImportChromosomes(const vector<string>& textPaths, const vector<string>& packedPaths,
+                                                     Work_Stealing_Pool& pool, size_t segmentBases = DEFAULT_IMPORT_SEGMENT);
+}
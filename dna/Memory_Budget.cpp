@@ -0,0 +1,131 @@
+#include "Memory_Budget.hpp"
+
+#include <algorithm>
+
+namespace dna
+{
+    Memory_Budget::Memory_Budget(size_t capacity, Policy policy) : capacity_(capacity), policy_(policy)
+    {
+    }
+
+    Memory_Reservation Memory_Budget::reserve(size_t bytes)
+    {
+        if (bytes > capacity_)
+            throw std::invalid_argument("reservation is larger than the memory budget");
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (used_ + bytes > capacity_)
+        {
+            if (policy_ == Policy::fail)
+                throw Memory_Budget_Exceeded("memory budget exceeded");
+            released_.wait(lock, [&] { return used_ + bytes <= capacity_; });
+        }
+
+        used_ += bytes;
+        peak_ = std::max(peak_, used_);
+        return Memory_Reservation(*this, bytes);
+    }
+
+    std::optional<Memory_Reservation> Memory_Budget::tryReserve(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (used_ + bytes > capacity_)
+            return std::nullopt;
+
+        used_ += bytes;
+        peak_ = std::max(peak_, used_);
+        return Memory_Reservation(*this, bytes);
+    }
+
+    size_t Memory_Budget::capacity() const
+    {
+        return capacity_;
+    }
+
+    size_t Memory_Budget::used() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return used_;
+    }
+
+    size_t Memory_Budget::peak() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return peak_;
+    }
+
+    Memory_Budget::Policy Memory_Budget::policy() const
+    {
+        return policy_;
+    }
+
+    void Memory_Budget::charge(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        used_ += bytes;
+        peak_ = std::max(peak_, used_);
+    }
+
+    void Memory_Budget::release(size_t bytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            used_ -= bytes;
+        }
+        released_.notify_all();
+    }
+
+    Memory_Reservation::Memory_Reservation(Memory_Budget& budget) : budget_(&budget)
+    {
+    }
+
+    Memory_Reservation::Memory_Reservation(Memory_Budget& budget, size_t bytes) : budget_(&budget), bytes_(bytes)
+    {
+    }
+
+    Memory_Reservation::~Memory_Reservation()
+    {
+        release();
+    }
+
+    Memory_Reservation::Memory_Reservation(Memory_Reservation&& other) noexcept :
+        budget_(other.budget_), bytes_(other.bytes_)
+    {
+        other.budget_ = nullptr;
+        other.bytes_ = 0;
+    }
+
+    Memory_Reservation& Memory_Reservation::operator=(Memory_Reservation&& other) noexcept
+    {
+        if (&other != this)
+        {
+            release();
+            budget_ = other.budget_;
+            bytes_ = other.bytes_;
+            other.budget_ = nullptr;
+            other.bytes_ = 0;
+        }
+        return *this;
+    }
+
+    void Memory_Reservation::grow(size_t bytes)
+    {
+        if (budget_ == nullptr)
+            throw std::invalid_argument("reservation does not belong to a memory budget");
+
+        budget_->charge(bytes);
+        bytes_ += bytes;
+    }
+
+    void Memory_Reservation::release()
+    {
+        if (budget_ != nullptr && bytes_ > 0)
+            budget_->release(bytes_);
+        bytes_ = 0;
+    }
+
+    size_t Memory_Reservation::bytes() const
+    {
+        return bytes_;
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace dna
+{
+    class Memory_Reservation;
+
+    // Thrown by a Memory_Budget with the fail policy when a reservation doesn't fit.
+    class Memory_Budget_Exceeded : public std::runtime_error
+    {
+    public:
+        explicit Memory_Budget_Exceeded(const std::string& what) : std::runtime_error(what) {}
+    };
+
+    // A cap on the memory that comparisons sharing it (typically everything on one node)
+    // may have in use at once.  Comparers reserve against it before allocating DP
+    // workspace and charge it for the transformations they buffer.  When a reservation
+    // doesn't fit, the wait policy holds the caller until others release theirs
+    // (throttling), and the fail policy throws Memory_Budget_Exceeded, which comparers
+    // turn into an incomplete, resumable comparison (spilling).  Safe to share between
+    // threads.
+    class Memory_Budget
+    {
+    public:
+        enum class Policy { wait, fail };
+
+        explicit Memory_Budget(size_t capacity, Policy policy = Policy::wait);
+
+        Memory_Budget(const Memory_Budget&) = delete;
+        Memory_Budget& operator=(const Memory_Budget&) = delete;
+
+        // Reserve the given number of bytes, waiting or throwing as the policy says.  A
+        // request larger than the whole budget could never be met and is an error.
+        Memory_Reservation reserve(size_t bytes);
+
+        // Reserve only if it fits right now, whatever the policy.
+        std::optional<Memory_Reservation> tryReserve(size_t bytes);
+
+        size_t capacity() const;
+        size_t used() const;
+        size_t peak() const;        // the most ever in use at once
+        Policy policy() const;
+
+    private:
+        friend class Memory_Reservation;
+
+        void charge(size_t bytes);
+        void release(size_t bytes);
+
+        const size_t capacity_;
+        const Policy policy_;
+        mutable std::mutex mutex_;
+        std::condition_variable released_;
+        size_t used_ = 0;
+        size_t peak_ = 0;
+    };
+
+    // Bytes held against a budget, given back when the reservation is released or
+    // destroyed.  An empty reservation belongs to no budget and holds nothing.
+    class Memory_Reservation
+    {
+    public:
+        Memory_Reservation() = default;
+
+        // Nothing yet, but able to grow against the budget.
+        explicit Memory_Reservation(Memory_Budget& budget);
+        ~Memory_Reservation();
+
+        Memory_Reservation(Memory_Reservation&& other) noexcept;
+        Memory_Reservation& operator=(Memory_Reservation&& other) noexcept;
+
+        Memory_Reservation(const Memory_Reservation&) = delete;
+        Memory_Reservation& operator=(const Memory_Reservation&) = delete;
+
+        // Hold more.  Memory that is already allocated can't be refused, so this never
+        // waits or fails, even if it takes the budget past its capacity; the next
+        // reservation then waits (or fails) until enough has been released.
+        void grow(size_t bytes);
+
+        void release();
+        size_t bytes() const;
+
+    private:
+        friend class Memory_Budget;
+
+        Memory_Reservation(Memory_Budget& budget, size_t bytes);
+
+        Memory_Budget* budget_ = nullptr;
+        size_t bytes_ = 0;
+    };
+}
@@ -0,0 +1,142 @@
+#include "Numa_Topology.hpp"
+
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace dna
+{
+    // From <linux/mempolicy.h>, which not every toolchain ships.
+    static const int MPOL_BIND_MODE = 2;
+    static const unsigned MPOL_MF_MOVE_PAGES = 1 << 1;
+
+    Numa_Topology::Numa_Topology(const string& nodeDirectory)
+    {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(nodeDirectory, error))
+        {
+            string name = entry.path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                continue;
+
+            std::ifstream in(entry.path() / "cpulist");
+            string list;
+            std::getline(in, list);
+            vector<int> cpus = ParseCpuList(list);
+            if (cpus.empty())
+                continue;       // a memory-only node; no workers can live there
+
+            ids_.push_back(std::stoi(name.substr(4)));
+            cpus_.push_back(std::move(cpus));
+        }
+
+        // Keep the nodes in the kernel's order.
+        vector<size_t> order(ids_.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return ids_[a] < ids_[b]; });
+        vector<int> ids;
+        vector<vector<int>> cpus;
+        for (size_t i : order)
+        {
+            ids.push_back(ids_[i]);
+            cpus.push_back(std::move(cpus_[i]));
+        }
+        ids_ = std::move(ids);
+        cpus_ = std::move(cpus);
+
+        if (ids_.empty())
+        {
+            ids_.push_back(0);
+            cpus_.emplace_back();
+            unsigned n = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned cpu = 0; cpu < n; cpu++)
+                cpus_.back().push_back(static_cast<int>(cpu));
+        }
+    }
+
+    const Numa_Topology& Numa_Topology::system()
+    {
+        static const Numa_Topology topology;
+        return topology;
+    }
+
+    size_t Numa_Topology::nodes() const
+    {
+        return ids_.size();
+    }
+
+    int Numa_Topology::nodeId(size_t node) const
+    {
+        if (node >= ids_.size())
+            throw std::invalid_argument("node is out of range");
+        return ids_[node];
+    }
+
+    const vector<int>& Numa_Topology::cpus(size_t node) const
+    {
+        if (node >= cpus_.size())
+            throw std::invalid_argument("node is out of range");
+        return cpus_[node];
+    }
+
+    vector<int> ParseCpuList(const string& list)
+    {
+        vector<int> cpus;
+        std::istringstream in(list);
+        string range;
+        while (std::getline(in, range, ','))
+        {
+            if (range.empty() || range == "\n")
+                continue;
+
+            size_t dash = range.find('-');
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+        }
+        return cpus;
+    }
+
+    bool PinThreadToNode(const Numa_Topology& topology, size_t node)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : topology.cpus(node))
+        {
+            if (cpu < CPU_SETSIZE)
+                CPU_SET(cpu, &set);
+        }
+        return ::sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+
+    bool BindMemoryToNode(const void* address, size_t length, int nodeId)
+    {
+        if (nodeId < 0 || nodeId >= 64 * 16)
+            return false;
+
+        // mbind() only works on whole pages.  Leave the partial ones at either end
+        // alone rather than dragging a neighbour's memory along.
+        uintptr_t page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+        uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page - 1) & ~(page - 1);
+        uintptr_t end = (reinterpret_cast<uintptr_t>(address) + length) & ~(page - 1);
+        if (end <= begin)
+            return true;
+
+        unsigned long mask[16] = {};
+        mask[nodeId / 64] = 1ul << (nodeId % 64);
+        long result = ::syscall(SYS_mbind, begin, end - begin, MPOL_BIND_MODE, mask,
+                                sizeof(mask) * 8, MPOL_MF_MOVE_PAGES);
+        return result == 0;
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace dna
+{
+    // The machine's NUMA nodes and the CPUs on each, as Linux reports them under
+    // /sys/devices/system/node.  Where that isn't available the machine looks like a
+    // single node with every CPU, and everything NUMA-aware quietly does nothing.
+    class Numa_Topology
+    {
+    public:
+        // Read from the given sysfs node directory.
+        explicit Numa_Topology(const string& nodeDirectory = "/sys/devices/system/node");
+
+        // The running machine's topology, read once.
+        static const Numa_Topology& system();
+
+        size_t nodes() const;
+        int nodeId(size_t node) const;              // the kernel's number for the node
+        const vector<int>& cpus(size_t node) const;
+
+    private:
+        vector<int> ids_;
+        vector<vector<int>> cpus_;
+    };
+
+    // Parse a kernel CPU list such as "0-3,8,10-11".
+    vector<int> ParseCpuList(const string& list);
+
+    // Restrict the calling thread to the CPUs of a node.  Returns false if the kernel
+    // wouldn't do it.
+    bool PinThreadToNode(const Numa_Topology& topology, size_t node);
+
+    // Bind the whole pages of [address, address + length) to the node with the given
+    // kernel number, moving any that are already elsewhere.  Returns false if the
+    // kernel wouldn't do it, for instance in a container without the permission.
+    bool BindMemoryToNode(const void* address, size_t length, int nodeId);
+}
@@ -0,0 +1,79 @@
+#include "Object_Store.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dna
+{
+    static std::atomic<std::uint64_t> nextStoreId{1};
+
+    Object_Store::Object_Store() : id_(nextStoreId++)
+    {
+    }
+
+    Local_Object_Store::Local_Object_Store(const string& root, std::chrono::microseconds latency, size_t bytesPerSecond) :
+        root_(root), latency_(latency), bytesPerSecond_(bytesPerSecond)
+    {
+    }
+
+    size_t Local_Object_Store::size(const string& key)
+    {
+        simulateTransfer(0);
+
+        struct stat st;
+        if (::stat(pathOf(key).c_str(), &st) != 0)
+            throw std::system_error(errno, std::generic_category(), "no such object " + key);
+        return static_cast<size_t>(st.st_size);
+    }
+
+    size_t Local_Object_Store::get(const string& key, size_t offset, size_t length, std::byte* out)
+    {
+        int fd = ::open(pathOf(key).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "no such object " + key);
+
+        size_t got = 0;
+        while (got < length)
+        {
+            ssize_t n = ::pread(fd, out + got, length - got, static_cast<off_t>(offset + got));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+            {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "unable to read object " + key);
+            }
+            if (n == 0)
+                break;
+            got += static_cast<size_t>(n);
+        }
+        ::close(fd);
+
+        simulateTransfer(got);
+        return got;
+    }
+
+    string Local_Object_Store::pathOf(const string& key) const
+    {
+        if (key.empty() || key.find("..") != string::npos)
+            throw std::invalid_argument("invalid object key: " + key);
+        return root_ + "/" + key;
+    }
+
+    void Local_Object_Store::simulateTransfer(size_t bytes) const
+    {
+        auto delay = latency_;
+        if (bytesPerSecond_ > 0)
+            delay += std::chrono::microseconds(bytes * 1000000 / bytesPerSecond_);
+        if (delay.count() > 0)
+            std::this_thread::sleep_for(delay);
+    }
+}
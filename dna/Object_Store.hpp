@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+namespace dna
+{
+    // The storage service that genomes live in (S3 in production).  Objects are
+    // immutable blobs of packed chromosome data addressed by key, and are only ever
+    // fetched in ranges.
+    class Object_Store
+    {
+    public:
+        Object_Store();
+        virtual ~Object_Store() = default;
+
+        // Unique to this store and never reused within the process, unlike its address,
+        // so that caches can tell stores apart.
+        std::uint64_t id() const { return id_; }
+
+        // The size of the object in bytes (a HEAD request).
+        virtual size_t size(const string& key) = 0;
+
+        // Fetch length bytes starting at offset into out (a ranged GET).
+        // Returns the number of bytes fetched, which is only short at the end of the object.
+        virtual size_t get(const string& key, size_t offset, size_t length, std::byte* out) = 0;
+
+    private:
+        std::uint64_t id_;
+    };
+
+    // An object store over a local directory, one file per key.  It can inject the
+    // latency and bandwidth of a remote store so that caching and read-ahead can be
+    // exercised without a network.
+    class Local_Object_Store : public Object_Store
+    {
+        string root_;
+        std::chrono::microseconds latency_;
+        size_t bytesPerSecond_;
+
+    public:
+        // A bytesPerSecond of zero means unlimited bandwidth.
+        explicit Local_Object_Store(const string& root,
+                                    std::chrono::microseconds latency = std::chrono::microseconds(0),
+                                    size_t bytesPerSecond = 0);
+
+        size_t size(const string& key) override;
+        size_t get(const string& key, size_t offset, size_t length, std::byte* out) override;
+
+    private:
+        string pathOf(const string& key) const;
+        void simulateTransfer(size_t bytes) const;
+    };
+}
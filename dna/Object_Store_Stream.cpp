@@ -0,0 +1,111 @@
+#include "Object_Store_Stream.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace dna
+{
+    Object_Store_Stream::Object_Store_Stream(std::shared_ptr<Object_Store> store, const string& key, size_t chunksize,
+                                             std::shared_ptr<Chunk_Cache> cache) :
+        store_(std::move(store)), cache_(std::move(cache)), key_(key), chunksize_(chunksize)
+    {
+        if (!store_)
+            throw std::invalid_argument("an object store is required");
+        if (chunksize_ == 0)
+            throw std::invalid_argument("chunk size must be positive");
+
+        size_ = store_->size(key_);
+    }
+
+    // Set the offset position in the stream to the given offset position.
+    // NB: This offset is an absolute position, not relative to the current position.
+    void Object_Store_Stream::seek(size_t offset)
+    {
+        offset_ = std::min(offset, size_);
+    }
+
+    size_t Object_Store_Stream::size() const
+    {
+        return size_;
+    }
+
+    size_t Object_Store_Stream::chunkSize() const
+    {
+        return chunksize_;
+    }
+
+    sequence_buffer<byte_view> Object_Store_Stream::read()
+    {
+        return read(chunksize_);
+    }
+
+    sequence_buffer<byte_view> Object_Store_Stream::read(size_t maxBytes)
+    {
+        maxBytes = std::min(maxBytes, size_ - offset_);
+        if (maxBytes == 0)
+            return byte_view(nullptr, 0);
+
+        size_t within = offset_ % chunksize_;
+        const auto& first = chunk(offset_ / chunksize_);
+        if (within + maxBytes <= first.size())
+        {
+            offset_ += maxBytes;
+            return byte_view(first.data() + within, maxBytes);
+        }
+
+        // The read straddles chunks.  Stitch them together.
+        staging_.clear();
+        while (staging_.size() < maxBytes)
+        {
+            within = offset_ % chunksize_;
+            const auto& next = chunk(offset_ / chunksize_);
+            if (within >= next.size())
+                break;
+
+            size_t take = std::min(maxBytes - staging_.size(), next.size() - within);
+            staging_.insert(staging_.end(), next.begin() + static_cast<long>(within),
+                            next.begin() + static_cast<long>(within + take));
+            offset_ += take;
+        }
+        return byte_view(staging_.data(), staging_.size());
+    }
+
+    bool Object_Store_Stream::atEnd() const
+    {
+        return offset_ == size_;
+    }
+
+    void Object_Store_Stream::advanceToEnd()
+    {
+        seek(size());
+    }
+
+    const Chunk_Cache::Chunk& Object_Store_Stream::chunk(size_t index)
+    {
+        if (current_ && currentIndex_ == index)
+            return *current_;
+
+        if (cache_)
+            current_ = cache_->get(Chunk_Cache::Key{ store_->id(), key_, chunksize_, index },
+                                   [&] { return fetch(index); });
+        else
+            current_ = std::make_shared<const Chunk_Cache::Chunk>(fetch(index));
+
+        currentIndex_ = index;
+        return *current_;
+    }
+
+    Chunk_Cache::Chunk Object_Store_Stream::fetch(size_t index) const
+    {
+        size_t offset = index * chunksize_;
+        Chunk_Cache::Chunk data(std::min(chunksize_, size_ - offset));
+
+        // Every chunk lies within the object, so a short GET means the object changed or
+        // the store failed.  Throwing keeps the short chunk out of the cache, and keeps
+        // the stream from handing out empty reads that never reach the end.
+        size_t got = store_->get(key_, offset, data.size(), data.data());
+        if (got != data.size())
+            throw std::runtime_error("short read of object " + key_);
+        return data;
+    }
+}
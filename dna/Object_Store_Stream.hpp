@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "sequence_buffer.hpp"
+#include "byte_view.hpp"
+#include "Object_Store.hpp"
+#include "Chunk_Cache.hpp"
+
+using std::string;
+
+namespace dna
+{
+    // A helix stream over a chromosome object in an object store.  Data is fetched
+    // with ranged GETs one chunk at a time, through a shared chunk cache when one is
+    // given.  Copies are cheap and have their own position, so several comparisons
+    // can stream the same object at once.
+    // The buffer returned by read() is only valid until the next read() or seek().
+    class Object_Store_Stream
+    {
+        std::shared_ptr<Object_Store> store_;
+        std::shared_ptr<Chunk_Cache> cache_;
+        string key_;
+        size_t size_;
+        size_t chunksize_;
+        size_t offset_ = 0;
+        Chunk_Cache::Chunk_Ptr current_;
+        size_t currentIndex_ = 0;
+        Chunk_Cache::Chunk staging_;
+
+    public:
+        Object_Store_Stream(std::shared_ptr<Object_Store> store, const string& key, size_t chunksize = 512,
+                            std::shared_ptr<Chunk_Cache> cache = nullptr);
+
+        void seek(size_t offset);
+        size_t size() const;
+        size_t chunkSize() const;
+        sequence_buffer<byte_view> read();
+        sequence_buffer<byte_view> read(size_t maxBytes);
+
+        bool atEnd() const;
+        void advanceToEnd();
+
+    private:
+        const Chunk_Cache::Chunk& chunk(size_t index);
+        Chunk_Cache::Chunk fetch(size_t index) const;
+    };
+}
@@ -0,0 +1,135 @@
+#include "Packed_Transformations.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+namespace dna
+{
+    size_t Transformation_View::index() const
+    {
+        return static_cast<size_t>(storage_->indexes_[i_]);
+    }
+
+    TransformType Transformation_View::type() const
+    {
+        return static_cast<TransformType>(storage_->types_[i_]);
+    }
+
+    sequence_buffer<byte_view> Transformation_View::s1() const
+    {
+        return storage_->bases(storage_->begin(i_), storage_->s1Lengths_[i_]);
+    }
+
+    sequence_buffer<byte_view> Transformation_View::s2() const
+    {
+        size_t from = storage_->begin(i_) + storage_->s1Lengths_[i_];
+        return storage_->bases(from, storage_->ends_[i_] - from);
+    }
+
+    static string toString(const sequence_buffer<byte_view>& bases)
+    {
+        string result(bases.size(), 'A');
+        for (size_t i = 0; i < bases.size(); i++)
+            result[i] = to_char(bases[i]);
+        return result;
+    }
+
+    Transformation_View::operator Transformation() const
+    {
+        if (type() == SUBSTITUTION)
+            return Transformation(index(), type(), toString(s1()), toString(s2()));
+        return Transformation(index(), type(), toString(s1()));
+    }
+
+    ostream& operator << (ostream& ostr, const Transformation_View& t)
+    {
+        return ostr << static_cast<Transformation>(t);
+    }
+
+    static bool isBases(std::string_view text)
+    {
+        return text.find_first_not_of("ACGT") == std::string_view::npos;
+    }
+
+    Packed_Transformations::Packed_Transformations(const vector<Transformation>& transformations)
+    {
+        size_t bases = 0;
+        for (const auto& t : transformations)
+            bases += t.s1.size() + t.s2.size();
+        reserve(transformations.size(), bases);
+
+        for (const auto& t : transformations)
+            push_back(t);
+    }
+
+    void Packed_Transformations::push_back(const Transformation& t)
+    {
+        emplace_back(t.index, t.type, t.s1, t.s2);
+    }
+
+    void Packed_Transformations::emplace_back(size_t index, TransformType type, std::string_view s1, std::string_view s2)
+    {
+        if (s1.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::invalid_argument("transformation string too long to pack");
+        if (!isBases(s1) || !isBases(s2))
+            throw std::invalid_argument("transformation strings must be made of A, C, G and T to pack");
+
+        appendBases(s1);
+        appendBases(s2);
+        indexes_.push_back(index);
+        types_.push_back(static_cast<std::uint8_t>(type));
+        s1Lengths_.push_back(static_cast<std::uint32_t>(s1.size()));
+        ends_.push_back(bases_);
+    }
+
+    void Packed_Transformations::reserve(size_t transformations, size_t bases)
+    {
+        indexes_.reserve(transformations);
+        types_.reserve(transformations);
+        s1Lengths_.reserve(transformations);
+        ends_.reserve(transformations);
+        arena_.reserve((bases + packed_size::value - 1) / packed_size::value);
+    }
+
+    void Packed_Transformations::clear()
+    {
+        indexes_.clear();
+        types_.clear();
+        s1Lengths_.clear();
+        ends_.clear();
+        arena_.clear();
+        bases_ = 0;
+    }
+
+    vector<Transformation> Packed_Transformations::unpack() const
+    {
+        return vector<Transformation>(begin(), end());
+    }
+
+    size_t Packed_Transformations::memoryBytes() const
+    {
+        return indexes_.capacity() * sizeof(std::uint64_t) +
+               types_.capacity() * sizeof(std::uint8_t) +
+               s1Lengths_.capacity() * sizeof(std::uint32_t) +
+               ends_.capacity() * sizeof(std::uint64_t) +
+               arena_.capacity();
+    }
+
+    void Packed_Transformations::appendBases(std::string_view bases)
+    {
+        for (char c : bases)
+        {
+            size_t phase = bases_ % packed_size::value;
+            if (phase == 0)
+                arena_.push_back(std::byte{0});
+            arena_.back() |= static_cast<std::byte>(to_base(c)) << (2 * (packed_size::value - 1 - phase));
+            bases_++;
+        }
+    }
+
+    sequence_buffer<byte_view> Packed_Transformations::bases(size_t from, size_t count) const
+    {
+        sequence_buffer<byte_view> all(byte_view(arena_.data(), arena_.size()), 0, bases_);
+        return all.subsequence(from, count);
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "byte_view.hpp"
+#include "sequence_buffer.hpp"
+#include "Transformation.hpp"
+
+using std::string;
+using std::vector;
+
+namespace dna
+{
+    class Packed_Transformations;
+
+    // One transformation in a Packed_Transformations, read in place.  Its strings are
+    // views of the packed bases, valid until the storage is changed.
+    class Transformation_View
+    {
+        const Packed_Transformations* storage_;
+        size_t i_;
+
+    public:
+        Transformation_View(const Packed_Transformations* storage, size_t i) : storage_(storage), i_(i) {}
+
+        size_t index() const;
+        TransformType type() const;
+        sequence_buffer<byte_view> s1() const;
+        sequence_buffer<byte_view> s2() const;
+
+        // A Transformation of its own, strings and all.
+        operator Transformation() const;
+    };
+
+    ostream& operator << (ostream& ostr, const Transformation_View& t);
+
+    // Transformations stored as a structure of arrays: indexes, types and string
+    // lengths side by side, and every string's bases packed four to a byte, one after
+    // another, in a single arena.  A Transformation is 80 bytes before its strings
+    // outgrow the small-string buffer; here one is 21 bytes plus a quarter of a byte
+    // per base, there is nothing to allocate per transformation, and scanning them reads
+    // memory in order.  The strings must be made of A, C, G and T.
+    class Packed_Transformations
+    {
+    public:
+        class const_iterator
+        {
+            const Packed_Transformations* storage_ = nullptr;
+            size_t i_ = 0;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using iterator_concept = std::random_access_iterator_tag;
+            using value_type = Transformation;
+            using difference_type = std::ptrdiff_t;
+            using reference = Transformation_View;
+            using pointer = void;
+
+            const_iterator() = default;
+            const_iterator(const Packed_Transformations* storage, size_t i) : storage_(storage), i_(i) {}
+
+            reference operator*() const { return Transformation_View(storage_, i_); }
+            reference operator[](difference_type n) const { return *(*this + n); }
+
+            const_iterator& operator++() { ++i_; return *this; }
+            const_iterator operator++(int) { const_iterator result = *this; ++i_; return result; }
+            const_iterator& operator--() { --i_; return *this; }
+            const_iterator operator--(int) { const_iterator result = *this; --i_; return result; }
+            const_iterator& operator+=(difference_type n) { i_ += n; return *this; }
+            const_iterator& operator-=(difference_type n) { i_ -= n; return *this; }
+            const_iterator operator+(difference_type n) const { return const_iterator(storage_, i_ + n); }
+            const_iterator operator-(difference_type n) const { return const_iterator(storage_, i_ - n); }
+            friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+            difference_type operator-(const const_iterator& other) const
+            {
+                return static_cast<difference_type>(i_ - other.i_);
+            }
+
+            bool operator==(const const_iterator& other) const { return storage_ == other.storage_ && i_ == other.i_; }
+            auto operator<=>(const const_iterator& other) const { return i_ <=> other.i_; }
+        };
+
+        Packed_Transformations() = default;
+        explicit Packed_Transformations(const vector<Transformation>& transformations);
+
+        void push_back(const Transformation& t);
+        void emplace_back(size_t index, TransformType type, std::string_view s1, std::string_view s2 = {});
+
+        // Make room ahead of time for this many transformations with this many bases.
+        void reserve(size_t transformations, size_t bases = 0);
+        void clear();
+
+        size_t size() const { return indexes_.size(); }
+        bool empty() const { return indexes_.empty(); }
+        Transformation_View operator[](size_t i) const { return Transformation_View(this, i); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        // Everything as plain Transformations again.
+        vector<Transformation> unpack() const;
+
+        // What the storage holds on to, reserved space included.
+        size_t memoryBytes() const;
+
+    private:
+        friend class Transformation_View;
+
+        void appendBases(std::string_view bases);
+        size_t begin(size_t i) const { return i == 0 ? 0 : ends_[i - 1]; }
+        sequence_buffer<byte_view> bases(size_t from, size_t count) const;
+
+        vector<std::uint64_t> indexes_;
+        vector<std::uint8_t> types_;
+        vector<std::uint32_t> s1Lengths_;
+        vector<std::uint64_t> ends_;        // where each one's s2 ends in the arena, in bases
+        vector<std::byte> arena_;
+        size_t bases_ = 0;
+    };
+}
@@ -1,7 +1,10 @@
 #include "Person.hpp"
 #include "Chromosome_Comparer.hpp"
+#include "Cost_Model.hpp"
 
-#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 namespace dna
 {
@@ -31,13 +34,19 @@ namespace dna
         return chroms_.size();
     }
 
-    static void CompareChromosomes(int number, DNA_Stream& c1, DNA_Stream& c2, Chromosome_Comparison& result)
+    // Segments are cut so that every worker gets about this many of them: enough that the
+    // last few to finish are small, few enough that the task overhead doesn't show.
+    static const std::size_t SEGMENTS_PER_WORKER = 4;
+
+    // ...and never smaller than this many chunks.
+    static const std::size_t MINIMUM_CHUNKS_PER_SEGMENT = 16;
+
+    vector<Chromosome_Comparison> Person::Compare(Person& other)
     {
-        Chromosome_Comparer comparer(number, c1, c2);
-        result = comparer.Compare();
+        return Compare(other, Work_Stealing_Pool::shared());
     }
 
-    vector<Chromosome_Comparison> Person::Compare(Person& other)
+    vector<Chromosome_Comparison> Person::Compare(Person& other, Work_Stealing_Pool& pool, const Comparison_Options& options)
     {
         vector<Chromosome_Comparison> comparisons;
 
@@ -46,27 +55,214 @@ namespace dna
         int numChromosomes = IsSameSexAs(other) ? NUM_CHROMS : NUM_CHROMS-1;
         comparisons.resize(numChromosomes);
 
-        // Compare each corresponding pair of chromosomes, each comparison in a separate thread.
-        vector<std::thread> threads;
-        threads.reserve(numChromosomes);
+        // The comparers seek and read their streams, so each works on copies of its own:
+        // the same person may be in other comparisons at the same time.
+        vector<DNA_Stream> streams1, streams2;
+        streams1.reserve(numChromosomes);
+        streams2.reserve(numChromosomes);
+        for (int i = 0; i < numChromosomes; i++)
+        {
+            streams1.push_back(chromosome(i));
+            streams2.push_back(other.chromosome(i));
+        }
+
+        vector<std::unique_ptr<Chromosome_Comparer>> comparers(numChromosomes);
+        vector<vector<Comparison_Segment>> segments(numChromosomes);
+        vector<std::atomic<std::size_t>> outstanding(numChromosomes);
+
+        // On a NUMA machine each chromosome pair gets a node: its data is moved there
+        // and only that node's workers are handed its segments.
+        auto nodeOf = [&](int i) { return static_cast<size_t>(i) % pool.nodes(); };
+
+        // Segments are measured from the end of the telomeres, so find those first.
+        {
+            Task_Group group(pool);
+            for (int i = 0; i < numChromosomes; i++)
+            {
+                group.runOn(nodeOf(i), [&, i] {
+                    if (pool.topology() != nullptr)
+                    {
+                        streams1[i].bindToNode(pool.topology()->nodeId(nodeOf(i)));
+                        streams2[i].bindToNode(pool.topology()->nodeId(nodeOf(i)));
+                    }
+
+                    comparers[i] = std::make_unique<Chromosome_Comparer>(i, streams1[i], streams2[i], options);
+                    comparers[i]->Prepare();
+                });
+            }
+            group.wait();
+        }
+
+        // Chromosome 1 is five times the size of chromosome 21.  Left whole it would bound
+        // the run on its own, so chromosomes that cost more than a worker's fair share are
+        // cut into pieces, and the pieces are handed out most expensive first.
+        Cost_Model model(options);
+        vector<double> costs(numChromosomes);
+        double total = 0;
         for (int i = 0; i < numChromosomes; i++)
         {
-            std::thread th(CompareChromosomes, i,
-                            std::ref(chromosome(i)),
-                            std::ref(other.chromosome(i)),
-                            std::ref(comparisons[i]));
-            threads.push_back(std::move(th));
+            costs[i] = model.estimate(chromosome(i).size(), other.chromosome(i).size(), chromosome(i).chunkSize());
+            total += costs[i];
         }
+        double target = total / static_cast<double>(pool.workers() * SEGMENTS_PER_WORKER);
 
-        // Now wait for the completion of the computations.
+        struct Job
+        {
+            int chromosome;
+            size_t segment;
+        };
+        vector<vector<Job>> jobs(pool.nodes());
+        vector<vector<double>> jobCosts(pool.nodes());
         for (int i = 0; i < numChromosomes; i++)
         {
-            threads[i].join();
+            size_t bytes = std::max(chromosome(i).size(), other.chromosome(i).size());
+            size_t chunk = chromosome(i).chunkSize();
+            segments[i] = comparers[i]->Split(model.segmentBytes(bytes, costs[i], target, chunk * MINIMUM_CHUNKS_PER_SEGMENT));
+            outstanding[i] = segments[i].size();
+
+            for (size_t j = 0; j < segments[i].size(); j++)
+            {
+                size_t begin = std::min(segments[i][j].begin, bytes);
+                size_t length = std::min(segments[i][j].end, bytes) - begin;
+                jobs[nodeOf(i)].push_back({i, j});
+                jobCosts[nodeOf(i)].push_back(model.estimate(length, length, chunk));
+            }
+        }
+
+        // The pool's deques are LIFO for their owners, so rather than rely on the order
+        // tasks are queued in, each node's workers pull from its list in cost order.
+        // Whichever segment of a chromosome finishes last stitches its comparison together.
+        size_t perNode = std::max<size_t>(pool.workers() / pool.nodes(), 1);
+        vector<std::atomic<std::size_t>> next(pool.nodes());
+        Task_Group group(pool);
+        for (size_t node = 0; node < pool.nodes(); node++)
+        {
+            vector<size_t> order = LongestFirst(jobCosts[node]);
+            vector<Job> sorted;
+            sorted.reserve(order.size());
+            for (size_t k : order)
+                sorted.push_back(jobs[node][k]);
+            jobs[node] = std::move(sorted);
+
+            for (size_t w = 0; w < std::min(perNode, jobs[node].size()); w++)
+            {
+                group.runOn(node, [&, node] {
+                    for (size_t k; (k = next[node]++) < jobs[node].size(); )
+                    {
+                        int i = jobs[node][k].chromosome;
+                        comparers[i]->CompareSegment(segments[i][jobs[node][k].segment]);
+                        if (--outstanding[i] == 0)
+                            comparisons[i] = comparers[i]->Finish(segments[i]);
+                    }
+                });
+            }
+        }
+        group.wait();
+
+        return comparisons;
+    }
+
+    vector<Chromosome_Comparison> Person::Resume(Person& other, const vector<Chromosome_Comparison>& partial,
+                                                 Work_Stealing_Pool& pool, const Comparison_Options& options)
+    {
+        vector<Chromosome_Comparison> comparisons(partial);
+
+        Task_Group group(pool);
+        for (std::size_t i = 0; i < comparisons.size(); i++)
+        {
+            if (comparisons[i].complete)
+                continue;
+
+            group.run([&, i] {
+                int number = comparisons[i].chromosome;
+                DNA_Stream c1 = chromosome(number);
+                DNA_Stream c2 = other.chromosome(number);
+                Chromosome_Comparer comparer(number, c1, c2, options);
+                comparisons[i] = comparer.Resume(comparisons[i]);
+            });
+        }
+        group.wait();
+
+        return comparisons;
+    }
+
+    vector<vector<Chromosome_Comparison>> Person::CompareAgainst(std::span<Person> others)
+    {
+        return CompareAgainst(others, Work_Stealing_Pool::shared());
+    }
+
+    vector<vector<Chromosome_Comparison>> Person::CompareAgainst(std::span<Person> others, Work_Stealing_Pool& pool,
+                                                                 const Comparison_Options& options)
+    {
+        vector<vector<Chromosome_Comparison>> comparisons(others.size());
+        for (std::size_t j = 0; j < others.size(); j++)
+            comparisons[j].resize(IsSameSexAs(others[j]) ? NUM_CHROMS : NUM_CHROMS-1);
+
+        // One fan-out per chromosome, over the others that have it to compare.  The
+        // streams are cheap copies, so the same person may turn up more than once.
+        Task_Group group(pool);
+        for (int i = 0; i < NUM_CHROMS; i++)
+        {
+            group.run([&, i] {
+                DNA_Stream query = chromosome(i);
+                vector<DNA_Stream> targets;
+                vector<std::size_t> owners;
+                targets.reserve(others.size());
+                for (std::size_t j = 0; j < others.size(); j++)
+                {
+                    if (static_cast<std::size_t>(i) < comparisons[j].size())
+                    {
+                        targets.push_back(others[j].chromosome(i));
+                        owners.push_back(j);
+                    }
+                }
+
+                vector<std::reference_wrapper<DNA_Stream>> refs(targets.begin(), targets.end());
+                Fan_Out_Comparer comparer(i, query, refs, options);
+                vector<Chromosome_Comparison> results = comparer.Compare(pool);
+                for (std::size_t k = 0; k < results.size(); k++)
+                    comparisons[owners[k]][i] = std::move(results[k]);
+            });
         }
+        group.wait();
 
         return comparisons;
     }
 
+    vector<Chromosome_Similarity> Person::Similarity(Person& other)
+    {
+        return Similarity(other, Work_Stealing_Pool::shared());
+    }
+
+    vector<Chromosome_Similarity> Person::Similarity(Person& other, Work_Stealing_Pool& pool)
+    {
+        vector<Chromosome_Similarity> similarities(IsSameSexAs(other) ? NUM_CHROMS : NUM_CHROMS-1);
+
+        Task_Group group(pool);
+        for (std::size_t i = 0; i < similarities.size(); i++)
+        {
+            group.run([&, i] {
+                // Screen what Compare() would compare: each side from just past its own
+                // leading telomeres, whatever phase that leaves it in, for as long as both
+                // go on.  The padding in the last bytes isn't known here, so the difference
+                // in length isn't counted.
+                DNA_Stream c1 = chromosome(i);
+                DNA_Stream c2 = other.chromosome(i);
+                Chromosome_Comparer comparer(static_cast<int>(i), c1, c2);
+                comparer.Prepare();
+
+                auto bases1 = c1.view(0, c1.size());
+                auto bases2 = c2.view(0, c2.size());
+                size_t common = std::min(bases1.size() - comparer.c1Start(), bases2.size() - comparer.c2Start());
+                similarities[i] = ScreenChromosome(static_cast<int>(i), bases1.subsequence(comparer.c1Start(), common),
+                                                   bases2.subsequence(comparer.c2Start(), common));
+            });
+        }
+        group.wait();
+
+        return similarities;
+    }
+
     bool Person::IsSameSexAs(Person& other)
     {
         // The last chromosome is a sex chromosome.  It is either a male (ie, Y) chromosome,
@@ -3,8 +3,12 @@
 #include "sequence_buffer.hpp"
 #include "DNA_Stream.hpp"
 #include "Chromosome_Comparison.hpp"
+#include "Comparison_Options.hpp"
+#include "Similarity.hpp"
+#include "Work_Stealing_Pool.hpp"
 
 #include <array>
+#include <span>
 
 #define NUM_CHROMS 23
 
@@ -37,7 +41,26 @@ public:
 
     std::size_t chromosomes() const;
 
+    // Compare on the process-wide pool, or on one of the caller's choosing.
     vector<Chromosome_Comparison> Compare(Person& other);
+    vector<Chromosome_Comparison> Compare(Person& other, Work_Stealing_Pool& pool, const Comparison_Options& options = {});
+
+    // Finish the chromosomes of an earlier Compare() that were stopped early.
+    vector<Chromosome_Comparison> Resume(Person& other, const vector<Chromosome_Comparison>& partial,
+                                         Work_Stealing_Pool& pool, const Comparison_Options& options = {});
+
+    // Compare against each of the others, reading this person's chromosomes only once.
+    // The result for others[j] is what Compare(others[j]) would return, and Resume()
+    // finishes any that the options stopped early.  Adaptive chunking doesn't apply.
+    vector<vector<Chromosome_Comparison>> CompareAgainst(std::span<Person> others);
+    vector<vector<Chromosome_Comparison>> CompareAgainst(std::span<Person> others, Work_Stealing_Pool& pool,
+                                                         const Comparison_Options& options = {});
+
+    // A substitution-only similarity per chromosome, at memory speed, to decide whether
+    // another person is worth a full Compare().  Covers the same chromosomes Compare() does,
+    // from the same starts past the leading telomeres, over the length both have from there.
+    vector<Chromosome_Similarity> Similarity(Person& other);
+    vector<Chromosome_Similarity> Similarity(Person& other, Work_Stealing_Pool& pool);
     bool IsSameSexAs(Person& other);
 
 private:
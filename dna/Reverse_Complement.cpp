@@ -0,0 +1,113 @@
+#include "Reverse_Complement.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace dna
+{
+    // Bytes [firstByte, firstByte + length) of the reverse complement of source.
+    static void reverseComplementRange(const sequence_buffer<byte_view>& source, size_t firstByte, size_t length,
+                                       std::byte* out)
+    {
+        const size_t wordBases = sequence_buffer<byte_view>::word_bases;
+        size_t bases = source.size();
+
+        for (size_t done = 0; done < length; done += sizeof(std::uint64_t))
+        {
+            // The 32 forward bases that end where this word of output begins, reversed.
+            // Near the start of the forward strand there are fewer than 32 of them; they
+            // get shifted up to the top and the rest of the word reads as padding.
+            size_t first = (firstByte + done) * packed_size::value;
+            size_t remaining = first < bases ? bases - first : 0;
+            std::uint64_t word = 0;
+            if (remaining >= wordBases)
+                word = ReverseComplementWord(source.word(bases - first - wordBases));
+            else if (remaining > 0)
+            {
+                std::uint64_t forward = source.word(0) & (~std::uint64_t(0) << (2 * (wordBases - remaining)));
+                word = ReverseComplementWord(forward) << (2 * (wordBases - remaining));
+            }
+
+            size_t bytes = std::min(sizeof(std::uint64_t), length - done);
+            for (size_t i = 0; i < bytes; i++)
+                out[done + i] = static_cast<std::byte>(word >> (8 * (sizeof(std::uint64_t) - 1 - i)));
+        }
+    }
+
+    void ReverseComplement(byte_view packed, size_t bases, std::byte* out)
+    {
+        if (bases > packed.size() * packed_size::value)
+            throw std::invalid_argument("more bases than the packed data holds");
+
+        sequence_buffer<byte_view> source(packed, bases);
+        reverseComplementRange(source, 0, (bases + packed_size::value - 1) / packed_size::value, out);
+    }
+
+    vector<std::byte> ReverseComplement(byte_view packed, size_t bases)
+    {
+        vector<std::byte> out((bases + packed_size::value - 1) / packed_size::value);
+        ReverseComplement(packed, bases, out.data());
+        return out;
+    }
+
+    DNA_Stream ReverseComplement(const DNA_Stream& stream, size_t padding)
+    {
+        if (padding >= packed_size::value || padding > stream.size() * packed_size::value)
+            throw std::invalid_argument("padding must be less than a byte of bases");
+
+        Genome_Buffer buffer(stream.size());
+        size_t bases = stream.size() * packed_size::value - padding;
+        ReverseComplement(stream.view(0, stream.size()).buffer(), bases, buffer.data());
+        return DNA_Stream(std::move(buffer), stream.chunkSize());
+    }
+
+    Reverse_Complement_Stream::Reverse_Complement_Stream(const DNA_Stream& forward, size_t padding) :
+        forward_(forward), bases_(forward.size() * packed_size::value - padding)
+    {
+        if (padding >= packed_size::value || padding > forward.size() * packed_size::value)
+            throw std::invalid_argument("padding must be less than a byte of bases");
+    }
+
+    void Reverse_Complement_Stream::seek(size_t offset)
+    {
+        offset_ = std::min(offset, size());
+    }
+
+    size_t Reverse_Complement_Stream::size() const
+    {
+        return forward_.size();
+    }
+
+    size_t Reverse_Complement_Stream::chunkSize() const
+    {
+        return forward_.chunkSize();
+    }
+
+    sequence_buffer<byte_view> Reverse_Complement_Stream::read()
+    {
+        return read(chunkSize());
+    }
+
+    sequence_buffer<byte_view> Reverse_Complement_Stream::read(size_t maxBytes)
+    {
+        size_t length = std::min(maxBytes, size() - offset_);
+        if (length == 0)
+            return byte_view(nullptr, 0);
+
+        buffer_.resize(length);
+        sequence_buffer<byte_view> source(forward_.view(0, forward_.size()).buffer(), bases_);
+        reverseComplementRange(source, offset_, length, buffer_.data());
+        offset_ += length;
+        return byte_view(buffer_.data(), length);
+    }
+
+    bool Reverse_Complement_Stream::atEnd() const
+    {
+        return offset_ == size();
+    }
+
+    void Reverse_Complement_Stream::advanceToEnd()
+    {
+        seek(size());
+    }
+}
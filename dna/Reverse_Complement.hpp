@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "byte_view.hpp"
+#include "sequence_buffer.hpp"
+#include "DNA_Stream.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // The reverse complement of 32 packed bases: the last base first, and every base
+    // swapped for its partner, which in the 2-bit code is flipping both of its bits.
+    constexpr std::uint64_t ReverseComplementWord(std::uint64_t word)
+    {
+        word = ((word >> 2) & 0x3333333333333333ull) | ((word & 0x3333333333333333ull) << 2);
+        word = ((word >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((word & 0x0F0F0F0F0F0F0F0Full) << 4);
+        word = ((word >> 8) & 0x00FF00FF00FF00FFull) | ((word & 0x00FF00FF00FF00FFull) << 8);
+        word = ((word >> 16) & 0x0000FFFF0000FFFFull) | ((word & 0x0000FFFF0000FFFFull) << 16);
+        word = (word >> 32) | (word << 32);
+        return ~word;
+    }
+
+    // The reverse complement of the first `bases` bases of packed data, packed the same
+    // way: (bases + 3) / 4 bytes, the last padded with 'A'.  Works 32 bases at a time,
+    // whatever the padding does to the phase.
+    void ReverseComplement(byte_view packed, size_t bases, std::byte* out);
+    vector<std::byte> ReverseComplement(byte_view packed, size_t bases);
+
+    // The opposite strand of an in-memory chromosome, whose last byte holds the given
+    // number of padding bases.
+    DNA_Stream ReverseComplement(const DNA_Stream& stream, size_t padding = 0);
+
+    // A helix stream that reads a chromosome's opposite strand: the reverse complement
+    // of the forward stream, produced a chunk at a time as it is read.  Copies share
+    // the forward stream's data.  The buffer returned by read() is only valid until the
+    // next read().
+    class Reverse_Complement_Stream
+    {
+        DNA_Stream forward_;
+        size_t bases_;
+        size_t offset_ = 0;
+        vector<std::byte> buffer_;
+
+    public:
+        explicit Reverse_Complement_Stream(const DNA_Stream& forward, size_t padding = 0);
+
+        void seek(size_t offset);
+        size_t size() const;
+        size_t chunkSize() const;
+        sequence_buffer<byte_view> read();
+        sequence_buffer<byte_view> read(size_t maxBytes);
+
+        bool atEnd() const;
+        void advanceToEnd();
+    };
+}
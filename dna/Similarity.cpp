@@ -0,0 +1,145 @@
+#include "Similarity.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DNA_HAVE_SIMD_MISMATCHES 1
+#endif
+
+namespace dna
+{
+    // A base differs if either of its two bits does.  Fold each pair onto its low bit
+    // and count those.
+    static constexpr std::uint64_t LOW_BITS = 0x5555555555555555ull;
+
+    static size_t countMismatchesScalar(const std::byte* a, const std::byte* b, size_t bytes)
+    {
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= bytes; i += sizeof(std::uint64_t))
+        {
+            std::uint64_t x, y;
+            std::memcpy(&x, a + i, sizeof(x));
+            std::memcpy(&y, b + i, sizeof(y));
+            std::uint64_t differ = x ^ y;
+            count += std::popcount((differ | (differ >> 1)) & LOW_BITS);
+        }
+        for (; i < bytes; i++)
+        {
+            unsigned differ = std::to_integer<unsigned>(a[i] ^ b[i]);
+            count += std::popcount((differ | (differ >> 1)) & 0x55u);
+        }
+        return count;
+    }
+
+#ifdef DNA_HAVE_SIMD_MISMATCHES
+    // AVX2 has no population count, so count each nibble with a shuffle and add the
+    // bytes up with sum-of-absolute-differences.
+    __attribute__((target("avx2")))
+    static size_t countMismatchesAvx2(const std::byte* a, const std::byte* b, size_t bytes)
+    {
+        const __m256i lows = _mm256_set1_epi8(0x55);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i counts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        __m256i total = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32)
+        {
+            __m256i differ = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+            __m256i folded = _mm256_and_si256(_mm256_or_si256(differ, _mm256_srli_epi16(differ, 1)), lows);
+            __m256i bits = _mm256_add_epi8(
+                _mm256_shuffle_epi8(counts, _mm256_and_si256(folded, nibble)),
+                _mm256_shuffle_epi8(counts, _mm256_and_si256(_mm256_srli_epi16(folded, 4), nibble)));
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(bits, _mm256_setzero_si256()));
+        }
+
+        size_t count = static_cast<size_t>(_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                                           _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+        return count + countMismatchesScalar(a + i, b + i, bytes - i);
+    }
+
+    __attribute__((target("avx512f,avx512vpopcntdq")))
+    static size_t countMismatchesAvx512(const std::byte* a, const std::byte* b, size_t bytes)
+    {
+        const __m512i lows = _mm512_set1_epi64(static_cast<long long>(LOW_BITS));
+        __m512i total = _mm512_setzero_si512();
+
+        size_t i = 0;
+        for (; i + 64 <= bytes; i += 64)
+        {
+            __m512i differ = _mm512_xor_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+            __m512i folded = _mm512_and_si512(_mm512_or_si512(differ, _mm512_srli_epi64(differ, 1)), lows);
+            total = _mm512_add_epi64(total, _mm512_popcnt_epi64(folded));
+        }
+
+        return static_cast<size_t>(_mm512_reduce_add_epi64(total)) + countMismatchesScalar(a + i, b + i, bytes - i);
+    }
+#endif
+
+    size_t CountMismatches(const std::byte* a, const std::byte* b, size_t bytes)
+    {
+#ifdef DNA_HAVE_SIMD_MISMATCHES
+        static const bool avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vpopcntdq");
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        if (avx512)
+            return countMismatchesAvx512(a, b, bytes);
+        if (avx2)
+            return countMismatchesAvx2(a, b, bytes);
+#endif
+        return countMismatchesScalar(a, b, bytes);
+    }
+
+    size_t CountMismatches(const sequence_buffer<byte_view>& a, const sequence_buffer<byte_view>& b)
+    {
+        if (a.size() != b.size())
+            throw std::invalid_argument("sequences to count mismatches between must be the same length");
+
+        // When both start on a byte boundary, whole bytes go through the kernel.  Out of
+        // phase, or for the last few bases, it's a word at a time.
+        size_t count = 0;
+        size_t done = 0;
+        if (a.offset() % packed_size::value == 0 && b.offset() % packed_size::value == 0)
+        {
+            size_t bytes = a.size() / packed_size::value;
+            count = CountMismatches(a.buffer().data() + a.offset() / packed_size::value,
+                                    b.buffer().data() + b.offset() / packed_size::value, bytes);
+            done = bytes * packed_size::value;
+        }
+        for (; done < a.size(); done += sequence_buffer<byte_view>::word_bases)
+        {
+            std::uint64_t differ = a.word(done) ^ b.word(done);
+            count += std::popcount((differ | (differ >> 1)) & LOW_BITS);
+        }
+        return count;
+    }
+
+    Chromosome_Similarity ScreenChromosome(int number, const sequence_buffer<byte_view>& a,
+                                           const sequence_buffer<byte_view>& b)
+    {
+        Chromosome_Similarity similarity;
+        similarity.chromosome = number;
+
+        size_t common = std::min(a.size(), b.size());
+        similarity.bases = std::max(a.size(), b.size());
+        if (similarity.bases == 0)
+            return similarity;
+
+        similarity.mismatches = similarity.bases - common;
+        similarity.mismatches += CountMismatches(a.subsequence(0, common), b.subsequence(0, common));
+        similarity.score = 1.0 - static_cast<double>(similarity.mismatches) / static_cast<double>(similarity.bases);
+        return similarity;
+    }
+
+    double Similarity(const sequence_buffer<byte_view>& a, const sequence_buffer<byte_view>& b)
+    {
+        return ScreenChromosome(0, a, b).score;
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include "byte_view.hpp"
+#include "sequence_buffer.hpp"
+
+namespace dna
+{
+    // How many bases differ between two equal-length runs of packed bases, counting
+    // substitutions only.  There is no alignment, so a single insertion makes everything
+    // after it look different: this is for screening candidates before the real
+    // comparison, not for replacing it.  Runs at memory speed, with AVX-512 VPOPCNTDQ or
+    // AVX2 where the processor has them.
+    size_t CountMismatches(const std::byte* a, const std::byte* b, size_t bytes);
+
+    // The same for two sequences of the same length, which needn't fill their last byte.
+    size_t CountMismatches(const sequence_buffer<byte_view>& a, const sequence_buffer<byte_view>& b);
+
+    // The substitution-only similarity of one pair of chromosomes.
+    struct Chromosome_Similarity
+    {
+        int chromosome = 0;
+        size_t bases = 0;           // positions compared: the longer of the two
+        size_t mismatches = 0;      // including the bases the shorter one lacks
+        double score = 1.0;         // the fraction that agree
+    };
+
+    // Screen two sequences position by position.  Bases one of them lacks count as
+    // mismatches, so sequences of very different lengths score low.
+    Chromosome_Similarity ScreenChromosome(int number, const sequence_buffer<byte_view>& a,
+                                           const sequence_buffer<byte_view>& b);
+
+    // Just the score: the fraction of positions at which the two agree.
+    double Similarity(const sequence_buffer<byte_view>& a, const sequence_buffer<byte_view>& b);
+}
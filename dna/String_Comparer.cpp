@@ -25,7 +25,8 @@ namespace dna
         }
 
         // Neither s1 nor s2 is empty.
-        auto table = buildLevenshteinTable(s1, s2);
+        Levenshtein_Table& table = threadTable();
+        buildLevenshteinTable(s1, s2, table);
 
         // Start in the lower right corner, where the Levenshtein number
         // is, and navigate through the implicit transformations to the
@@ -34,78 +35,49 @@ namespace dna
 
         size_t i = s1.size();
         size_t j = s2.size();
-        while (i > 1 || j > 1)
+        while (i > 0 && j > 0)
         {
-            int current = table[i][j];
-            if (i > 1 && j > 1)
+            int current = table(i, j);
+            int upperLeft = table(i - 1, j - 1);
+            int above = table(i - 1, j);
+            int left = table(i, j - 1);
+            // Figure out which of the three values to select.
+            if (upperLeft <= above && upperLeft <= left)
             {
-                int upperLeft = table[i - 1][j - 1];
-                int above = table[i - 1][j];
-                int left = table[i][j - 1];
-                // Figure out which of the three values to select.
-                if (upperLeft <= above && upperLeft <= left)
+                // Going up diagonally is the optimal choice.
+                if (upperLeft < current)
                 {
-                    // Going up diagonally is the optimal choice.
-                    if (upperLeft < current)
-                    {
-                        // The diagonal value changed.  That indicates a substitution.
-                        transformations.emplace_back(Transformation(i - 1, SUBSTITUTION,
-                            string(1, s1[i - 1]),
-                            string(1, s2[j - 1])));
-                    }
-                    i--;
-                    j--;
-                }
-                else if (above < left)
-                {
-                    // The value above is lower.  That indicates a deletion.
-                    transformations.emplace_back(Transformation(i - 1, DELETION, string(1, s1[i - 1])));
-                    i--;
-                }
-                else
-                {
-                    // The value on the left is lower. That indicates an insertion.
-                    transformations.emplace_back(Transformation(i, INSERTION, string(1, s2[j - 1])));
-                    j--;
+                    // The diagonal value changed.  That indicates a substitution.
+                    transformations.emplace_back(Transformation(i - 1, SUBSTITUTION,
+                        string(1, s1[i - 1]),
+                        string(1, s2[j - 1])));
                 }
+                i--;
+                j--;
             }
-            else if (i > 1)
+            else if (above < left)
             {
-                // j == 1.  We have reached the left column.  Go only up to capture the deletions.
-                int above = table[i - 1][j];
-                if (above < current)
-                {
-                    transformations.emplace_back(Transformation(0, DELETION, s1.substr(0, i)));
-                }
-                else
-                {
-                    transformations.emplace_back(Transformation(0, DELETION, s1.substr(0, i-1)));
-                }
-                i = 0;
+                // The value above is lower.  That indicates a deletion.
+                transformations.emplace_back(Transformation(i - 1, DELETION, string(1, s1[i - 1])));
+                i--;
             }
             else
             {
-                // i == 1.  We have reached the top row.  Go only left to capture the insertions.
-                int left = table[i][j - 1];
-                if (left < current)
-                {
-                    transformations.emplace_back(Transformation(0, INSERTION, s2.substr(0, j)));
-                }
-                else
-                {
-                    transformations.emplace_back(Transformation(0, INSERTION, s2.substr(0, j-1)));
-                }
-                j = 0;
+                // The value on the left is lower. That indicates an insertion.
+                transformations.emplace_back(Transformation(i, INSERTION, string(1, s2[j - 1])));
+                j--;
             }
         }
 
-        // Final check of the first letter
-        if (i == 1 && j == 1 && table[i][j] > 0)
+        // We have reached the top row or the left column.  Whatever is left of the one
+        // string has no counterpart in the other.
+        if (i > 0)
         {
-            // This was a substitution in the first letter.
-            transformations.emplace_back(Transformation(0, SUBSTITUTION,
-                string(1, s1[0]),
-                string(1, s2[0])));
+            transformations.emplace_back(Transformation(0, DELETION, s1.substr(0, i)));
+        }
+        else if (j > 0)
+        {
+            transformations.emplace_back(Transformation(0, INSERTION, s2.substr(0, j)));
         }
 
         // The transformations are for single character changes, and in reverse order.
@@ -116,39 +88,56 @@ namespace dna
         return transformations;
     }
 
-    vector<vector<int>> String_Comparer::buildLevenshteinTable(const string& s1, const string& s2) const
+    size_t String_Comparer::WorkspaceBytes(size_t s1Length, size_t s2Length)
     {
-        vector<vector<int>> table;
-        table.resize(s1.size() + 1);
-        for (int i = 0; i <= s1.size(); i++) {
-            table[i].resize(s2.size() + 1);
-        }
+        return (s1Length + 1) * (s2Length + 1) * sizeof(int);
+    }
+
+    size_t String_Comparer::RetainedWorkspaceBytes()
+    {
+        return threadTable().cells.capacity() * sizeof(int);
+    }
+
+    void String_Comparer::ReleaseWorkspace()
+    {
+        Levenshtein_Table& table = threadTable();
+        vector<int>().swap(table.cells);
+        table.columns = 0;
+    }
+
+    String_Comparer::Levenshtein_Table& String_Comparer::threadTable()
+    {
+        static thread_local Levenshtein_Table table;
+        return table;
+    }
+
+    void String_Comparer::buildLevenshteinTable(const string& s1, const string& s2, Levenshtein_Table& table) const
+    {
+        table.reset(s1.size() + 1, s2.size() + 1);
 
         // Initialize top row.
         for (int j = 0; j <= s2.size(); j++) {
-            table[0][j] = j;
+            table(0, j) = j;
         }
         // Initialize first column.
         for (int i = 1; i <= s1.size(); i++) {
-            table[i][0] = i;
+            table(i, 0) = i;
         }
         // Initialize internal rows.
         for (int i = 1; i <= s1.size(); i++) {
             for (int j = 1; j <= s2.size(); j++) {
-                table[i][j] = getLevenshteinValue(i, j, s1, s2, table);
+                table(i, j) = getLevenshteinValue(i, j, s1, s2, table);
             }
         }
-
-        return table;
     }
 
     int String_Comparer::getLevenshteinValue(int i, int j,
                                              const string& s1, const string& s2,
-                                             const vector<vector<int>>& table) const
+                                             const Levenshtein_Table& table) const
     {
-        int leftCell = table[i][j - 1] + 1;
-        int aboveCell = table[i - 1][j] + 1;
-        int upperLeftCell = table[i - 1][j - 1];
+        int leftCell = table(i, j - 1) + 1;
+        int aboveCell = table(i - 1, j) + 1;
+        int upperLeftCell = table(i - 1, j - 1);
         if (s1[i - 1] != s2[j - 1])
             upperLeftCell++;
         return min(leftCell, min(aboveCell, upperLeftCell));
@@ -18,11 +18,36 @@ namespace dna
         // Note that the transformations are cumulative, from the start to the end.
         vector<Transformation> Compare(const string& s1, const string& s2) const;
 
+        // The memory Compare() needs for its Levenshtein table, given the string lengths.
+        static size_t WorkspaceBytes(size_t s1Length, size_t s2Length);
+
+        // Every thread keeps its own table between comparisons, so that the memory stays
+        // allocated and warm.  What the calling thread's table holds on to, and giving it
+        // back, for comparisons that have to stay within a memory budget.
+        static size_t RetainedWorkspaceBytes();
+        static void ReleaseWorkspace();
+
     private:
-        vector<vector<int>> buildLevenshteinTable(const string& s1, const string& s2) const;
+        // The Levenshtein table, one row after the other in a single block.
+        struct Levenshtein_Table
+        {
+            vector<int> cells;
+            size_t columns = 0;
+
+            void reset(size_t rows, size_t cols)
+            {
+                columns = cols;
+                cells.resize(rows * cols);
+            }
+            int& operator()(size_t i, size_t j) { return cells[i * columns + j]; }
+            int operator()(size_t i, size_t j) const { return cells[i * columns + j]; }
+        };
+
+        static Levenshtein_Table& threadTable();
+        void buildLevenshteinTable(const string& s1, const string& s2, Levenshtein_Table& table) const;
         int getLevenshteinValue(int i, int j,
                                 const string& s1, const string& s2,
-                                const vector<vector<int>>& table) const;
+                                const Levenshtein_Table& table) const;
         void reviseTransformations(vector<Transformation>& transformations) const;
         bool canBeMerged(const vector<Transformation>& transformations, size_t i) const;
     };
@@ -0,0 +1,231 @@
+#include "Variant_Set.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace dna
+{
+    // Packed_Transformations hands out views, which turn into Transformations here.
+    template<typename Transformations>
+    static void addVariants(Variant_Set& set, const Transformations& transformations)
+    {
+        set.variants.reserve(transformations.size());
+
+        // Each index is into the reference with the earlier transformations applied, so
+        // take back however much they grew it.
+        long long growth = 0;
+        for (const Transformation& t : transformations)
+        {
+            Variant variant;
+            variant.position = static_cast<size_t>(static_cast<long long>(t.index) - growth);
+            variant.type = t.type;
+            if (t.type == INSERTION)
+            {
+                variant.alt = t.s1;
+                growth += static_cast<long long>(t.s1.size());
+            }
+            else if (t.type == DELETION)
+            {
+                variant.ref = t.s1;
+                growth -= static_cast<long long>(t.s1.size());
+            }
+            else
+            {
+                variant.ref = t.s1;
+                variant.alt = t.s2;
+            }
+            set.variants.push_back(std::move(variant));
+        }
+
+        // In order of position, whatever order the comparison found them in, with
+        // insertions in front of whatever else is at theirs.
+        std::stable_sort(set.variants.begin(), set.variants.end(), [](const Variant& x, const Variant& y) {
+            if (x.position != y.position)
+                return x.position < y.position;
+            return x.type == INSERTION && y.type != INSERTION;
+        });
+    }
+
+    // Sorted, and each variant past the stretch of the reference the one before it covers.
+    static void validate(const Variant_Set& set)
+    {
+        for (size_t i = 1; i < set.variants.size(); i++)
+        {
+            const Variant& previous = set.variants[i - 1];
+            const Variant& current = set.variants[i];
+            if (current.position < previous.position + previous.ref.size() ||
+                (current.position == previous.position && current.type == INSERTION))
+                throw std::invalid_argument("variant set is out of order or has overlapping variants");
+        }
+    }
+
+    Variant_Set Variant_Set::FromComparison(const Chromosome_Comparison& comparison)
+    {
+        Variant_Set set;
+        set.chromosome = comparison.chromosome;
+        set.referenceStart = comparison.c1Start;
+        set.personStart = comparison.c2Start;
+        if (!comparison.packedTransformations.empty())
+            addVariants(set, comparison.packedTransformations);
+        else
+            addVariants(set, comparison.transformations);
+        return set;
+    }
+
+    Chromosome_Comparison Variant_Set::toComparison() const
+    {
+        Chromosome_Comparison comparison;
+        comparison.chromosome = chromosome;
+        comparison.c1Start = referenceStart;
+        comparison.c2Start = personStart;
+
+        long long growth = 0;
+        for (const auto& v : variants)
+        {
+            size_t index = static_cast<size_t>(static_cast<long long>(v.position) + growth);
+            if (v.type == INSERTION)
+                comparison.transformations.emplace_back(index, INSERTION, v.alt);
+            else if (v.type == DELETION)
+                comparison.transformations.emplace_back(index, DELETION, v.ref);
+            else
+                comparison.transformations.emplace_back(index, SUBSTITUTION, v.ref, v.alt);
+            growth += static_cast<long long>(v.alt.size()) - static_cast<long long>(v.ref.size());
+        }
+        return comparison;
+    }
+
+    vector<Variant_Set> AlignToReference(Person& reference, Person& person, Work_Stealing_Pool& pool)
+    {
+        vector<Variant_Set> sets;
+        for (const auto& comparison : reference.Compare(person, pool))
+            sets.push_back(Variant_Set::FromComparison(comparison));
+        return sets;
+    }
+
+    // A variant from either set, on the way through the merge.
+    struct Tagged_Variant
+    {
+        const Variant* variant;
+        bool fromA;
+
+        size_t begin() const { return variant->position; }
+        size_t end() const { return variant->position + variant->ref.size(); }
+    };
+
+    // Apply one set's variants from a cluster to the reference stretch [begin, ...).
+    static string ApplyCluster(const string& ref, size_t begin, const vector<Tagged_Variant>& cluster, bool fromA)
+    {
+        string text;
+        size_t cursor = begin;
+        for (const auto& tagged : cluster)
+        {
+            if (tagged.fromA != fromA)
+                continue;
+            text.append(ref, cursor - begin, tagged.begin() - cursor);
+            text += tagged.variant->alt;
+            cursor = tagged.end();
+        }
+        text.append(ref, cursor - begin, string::npos);
+        return text;
+    }
+
+    Chromosome_Comparison CompareVariants(const Variant_Set& a, const Variant_Set& b)
+    {
+        if (a.chromosome != b.chromosome)
+            throw std::invalid_argument("variant sets are for different chromosomes");
+        if (a.referenceStart != b.referenceStart)
+            throw std::invalid_argument("variant sets are against different references");
+        validate(a);
+        validate(b);
+
+        Chromosome_Comparison comparison;
+        comparison.chromosome = a.chromosome;
+        comparison.c1Start = a.personStart;
+        comparison.c2Start = b.personStart;
+
+        // Merge the two sets into one sequence by position, insertions first.
+        vector<Tagged_Variant> merged;
+        merged.reserve(a.variants.size() + b.variants.size());
+        auto byPosition = [](const Tagged_Variant& x, const Tagged_Variant& y) {
+            if (x.begin() != y.begin())
+                return x.begin() < y.begin();
+            return x.variant->type == INSERTION && y.variant->type != INSERTION;
+        };
+        vector<Tagged_Variant> taggedA, taggedB;
+        for (const auto& v : a.variants)
+            taggedA.push_back({ &v, true });
+        for (const auto& v : b.variants)
+            taggedB.push_back({ &v, false });
+        std::merge(taggedA.begin(), taggedA.end(), taggedB.begin(), taggedB.end(), std::back_inserter(merged), byPosition);
+
+        // Everything before the current cluster already reads like B, so a reference
+        // position p is at p plus B's growth so far in the string being transformed.
+        // That string starts with A's leading telomeres rather than the reference's.
+        long long growthOfB = static_cast<long long>(a.personStart) - static_cast<long long>(a.referenceStart);
+        size_t i = 0;
+        while (i < merged.size())
+        {
+            // Gather the variants whose stretches of the reference overlap.
+            size_t begin = merged[i].begin();
+            size_t end = merged[i].end();
+            vector<Tagged_Variant> cluster{ merged[i++] };
+            while (i < merged.size() &&
+                   (merged[i].begin() < end || (begin == end && merged[i].begin() == begin)))
+            {
+                end = std::max(end, merged[i].end());
+                cluster.push_back(merged[i++]);
+            }
+
+            // The overlapping variants between them cover the whole stretch.
+            string ref(end - begin, 'N');
+            for (const auto& tagged : cluster)
+                ref.replace(tagged.begin() - begin, tagged.variant->ref.size(), tagged.variant->ref);
+
+            string textA = ApplyCluster(ref, begin, cluster, true);
+            string textB = ApplyCluster(ref, begin, cluster, false);
+            size_t index = static_cast<size_t>(static_cast<long long>(begin) + growthOfB);
+            growthOfB += static_cast<long long>(textB.size()) - static_cast<long long>(ref.size());
+
+            // Only what actually differs between A's and B's versions needs rewriting.
+            size_t prefix = 0;
+            while (prefix < textA.size() && prefix < textB.size() && textA[prefix] == textB[prefix])
+                prefix++;
+            size_t suffix = 0;
+            while (suffix < textA.size() - prefix && suffix < textB.size() - prefix &&
+                   textA[textA.size() - 1 - suffix] == textB[textB.size() - 1 - suffix])
+                suffix++;
+
+            string s1 = textA.substr(prefix, textA.size() - prefix - suffix);
+            string s2 = textB.substr(prefix, textB.size() - prefix - suffix);
+            index += prefix;
+            if (s1.empty() && s2.empty())
+                continue;
+            if (s1.empty())
+                comparison.transformations.emplace_back(index, INSERTION, s2);
+            else if (s2.empty())
+                comparison.transformations.emplace_back(index, DELETION, s1);
+            else if (s1.size() == s2.size())
+                comparison.transformations.emplace_back(index, SUBSTITUTION, s1, s2);
+            else
+            {
+                comparison.transformations.emplace_back(index, DELETION, s1);
+                comparison.transformations.emplace_back(index, INSERTION, s2);
+            }
+        }
+        return comparison;
+    }
+
+    vector<Chromosome_Comparison> CompareVariants(const vector<Variant_Set>& a, const vector<Variant_Set>& b)
+    {
+        vector<Chromosome_Comparison> comparisons;
+        comparisons.reserve(std::min(a.size(), b.size()));
+        for (const auto& set : a)
+        {
+            auto other = std::find_if(b.begin(), b.end(), [&](const Variant_Set& s) { return s.chromosome == set.chromosome; });
+            if (other != b.end())
+                comparisons.push_back(CompareVariants(set, *other));
+        }
+        return comparisons;
+    }
+}
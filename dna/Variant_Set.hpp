@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Chromosome_Comparison.hpp"
+#include "Person.hpp"
+#include "Transformation.hpp"
+#include "Work_Stealing_Pool.hpp"
+
+using std::string;
+using std::vector;
+
+namespace dna
+{
+    // A difference from the reference, at a position in the reference itself rather
+    // than in a partially transformed string.  An insertion goes in front of position.
+    struct Variant
+    {
+        size_t position = 0;
+        TransformType type = SUBSTITUTION;
+        string ref;                 // the reference bases replaced or deleted
+        string alt;                 // the bases substituted or inserted
+    };
+
+    // How one person's chromosome differs from the reference, sorted by position.
+    // Any two people aligned to the same reference can be compared from their sets
+    // alone, in time linear in the number of variants.  Positions count the reference's
+    // leading telomeres; referenceStart and personStart are where each chromosome
+    // starts past its own, in bases.
+    struct Variant_Set
+    {
+        int chromosome = 0;
+        vector<Variant> variants;
+        size_t referenceStart = 0;
+        size_t personStart = 0;
+
+        // From a comparison of the reference (first) against the person (second).
+        static Variant_Set FromComparison(const Chromosome_Comparison& comparison);
+
+        // Back to the reference-against-person comparison.
+        Chromosome_Comparison toComparison() const;
+    };
+
+    // Align each of the person's chromosomes to the reference's, once.
+    vector<Variant_Set> AlignToReference(Person& reference, Person& person, Work_Stealing_Pool& pool);
+
+    // The comparison of person A against person B, derived from their variant sets
+    // against the same reference.  Where both differ from the reference over the same
+    // stretch, the stretch is rewritten from A's version to B's in one step.  Throws
+    // std::invalid_argument if either set is out of order or has overlapping variants.
+    Chromosome_Comparison CompareVariants(const Variant_Set& a, const Variant_Set& b);
+
+    // CompareVariants() for each chromosome the two have in common, paired by number and
+    // in a's order.  A reference of the other sex leaves both without the sex
+    // chromosome, which then takes a direct Person::Compare().
+    vector<Chromosome_Comparison> CompareVariants(const vector<Variant_Set>& a, const vector<Variant_Set>& b);
+}
@@ -0,0 +1,257 @@
+#include "Work_Stealing_Pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace dna
+{
+    // Which pool, and which of its workers, the current thread is.
+    static thread_local Work_Stealing_Pool* currentPool = nullptr;
+    static thread_local size_t currentWorker = 0;
+
+    Work_Stealing_Pool::Work_Stealing_Pool(size_t numWorkers, const Numa_Topology* topology) :
+        topology_(topology)
+    {
+        size_t nodes = topology_ != nullptr ? topology_->nodes() : 1;
+        if (numWorkers == 0)
+        {
+            if (topology_ != nullptr)
+            {
+                for (size_t node = 0; node < nodes; node++)
+                    numWorkers += topology_->cpus(node).size();
+            }
+            numWorkers = std::max<size_t>(numWorkers, std::max(1u, std::thread::hardware_concurrency()));
+        }
+
+        // Spread the workers evenly, in blocks, over the nodes.
+        nodeWorkers_.resize(nodes);
+        for (size_t i = 0; i < numWorkers; i++)
+        {
+            workers_.push_back(std::make_unique<Worker>());
+            size_t node = i * nodes / numWorkers;
+            workerNode_.push_back(node);
+            nodeWorkers_[node].push_back(i);
+        }
+
+        threads_.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; i++)
+            threads_.emplace_back([this, i] { run(i); });
+    }
+
+    Work_Stealing_Pool::~Work_Stealing_Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            stopping_ = true;
+        }
+        idle_.notify_all();
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    Work_Stealing_Pool& Work_Stealing_Pool::shared()
+    {
+        const Numa_Topology& topology = Numa_Topology::system();
+        static Work_Stealing_Pool pool(0, topology.nodes() > 1 ? &topology : nullptr);
+        return pool;
+    }
+
+    void Work_Stealing_Pool::submit(Task task)
+    {
+        // Our own workers keep what they spawn.  Everybody else spreads work round robin.
+        size_t index = currentPool == this
+            ? currentWorker
+            : nextVictim_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+        push(index, std::move(task));
+    }
+
+    void Work_Stealing_Pool::submitTo(size_t node, Task task)
+    {
+        if (node >= nodeWorkers_.size() || nodeWorkers_[node].empty())
+        {
+            submit(std::move(task));
+            return;
+        }
+
+        // A worker of that node spawning more work for it keeps it; anybody else deals
+        // it out over the node's workers.
+        const auto& local = nodeWorkers_[node];
+        size_t index = currentPool == this && workerNode_[currentWorker] == node
+            ? currentWorker
+            : local[nextVictim_.fetch_add(1, std::memory_order_relaxed) % local.size()];
+        push(index, std::move(task));
+    }
+
+    void Work_Stealing_Pool::push(size_t index, Task task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+            workers_[index]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(idleMutex_);
+            queued_++;
+        }
+        idle_.notify_one();
+    }
+
+    bool Work_Stealing_Pool::tryRunOne()
+    {
+        Task task;
+        bool found = currentPool == this
+            ? popOwn(currentWorker, task) || steal(currentWorker, task)
+            : steal(workers_.size(), task);
+        if (!found)
+            return false;
+
+        task();
+        return true;
+    }
+
+    size_t Work_Stealing_Pool::workers() const
+    {
+        return workers_.size();
+    }
+
+    size_t Work_Stealing_Pool::nodes() const
+    {
+        return nodeWorkers_.size();
+    }
+
+    const Numa_Topology* Work_Stealing_Pool::topology() const
+    {
+        return topology_;
+    }
+
+    void Work_Stealing_Pool::run(size_t index)
+    {
+        currentPool = this;
+        currentWorker = index;
+        if (topology_ != nullptr)
+            PinThreadToNode(*topology_, workerNode_[index]);
+
+        while (true)
+        {
+            Task task;
+            if (popOwn(index, task) || steal(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(idleMutex_);
+            idle_.wait(lock, [&] { return stopping_ || queued_ > 0; });
+            if (stopping_ && queued_ == 0)
+                return;
+        }
+    }
+
+    bool Work_Stealing_Pool::popOwn(size_t index, Task& task)
+    {
+        Worker& worker = *workers_[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty())
+            return false;
+
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        queued_--;
+        return true;
+    }
+
+    bool Work_Stealing_Pool::steal(size_t thief, Task& task)
+    {
+        // Start with the neighbour so that thieves don't all pile onto worker 0.  On a
+        // NUMA machine, the first pass only looks at the thief's own node.
+        size_t n = workers_.size();
+        bool numa = thief < n && nodeWorkers_.size() > 1;
+        for (int pass = numa ? 0 : 1; pass < 2; pass++)
+        {
+            for (size_t i = 1; i <= n; i++)
+            {
+                size_t victim = (thief + i) % n;
+                if (victim == thief || (pass == 0 && workerNode_[victim] != workerNode_[thief]))
+                    continue;
+
+                Worker& worker = *workers_[victim];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                if (worker.tasks.empty())
+                    continue;
+
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+                queued_--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Task_Group::Task_Group(Work_Stealing_Pool& pool) : pool_(pool)
+    {
+    }
+
+    Task_Group::~Task_Group()
+    {
+        // The tasks refer to this group.  Don't go away underneath them.
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void Task_Group::run(Work_Stealing_Pool::Task task)
+    {
+        pool_.submit(track(std::move(task)));
+    }
+
+    void Task_Group::runOn(size_t node, Work_Stealing_Pool::Task task)
+    {
+        pool_.submitTo(node, track(std::move(task)));
+    }
+
+    Work_Stealing_Pool::Task Task_Group::track(Work_Stealing_Pool::Task task)
+    {
+        pending_++;
+        return [this, task = std::move(task)] {
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0)
+                done_.notify_all();
+        };
+    }
+
+    void Task_Group::wait()
+    {
+        while (pending_ > 0)
+        {
+            if (pool_.tryRunOne())
+                continue;
+
+            // Nothing to help with; the remaining tasks are running elsewhere.
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait_for(lock, std::chrono::milliseconds(1), [&] { return pending_ == 0; });
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_)
+        {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Numa_Topology.hpp"
+
+using std::vector;
+
+namespace dna
+{
+    // A fixed set of worker threads, each with its own deque of tasks.  A worker
+    // pushes and pops the tasks it spawns at the back of its own deque (LIFO, so the
+    // data it just touched is still in cache) and, when it runs dry, steals from the
+    // front of somebody else's (FIFO, so it takes the biggest, oldest piece of work).
+    // Given a NUMA topology, the workers are spread evenly over the nodes and pinned
+    // there, and they steal from their own node before going further afield.
+    class Work_Stealing_Pool
+    {
+    public:
+        using Task = std::function<void()>;
+
+        // Zero workers means one per hardware thread, or per CPU of the topology.
+        explicit Work_Stealing_Pool(size_t numWorkers = 0, const Numa_Topology* topology = nullptr);
+        ~Work_Stealing_Pool();
+
+        Work_Stealing_Pool(const Work_Stealing_Pool&) = delete;
+        Work_Stealing_Pool& operator=(const Work_Stealing_Pool&) = delete;
+
+        // A pool for the whole process, started on first use and kept until exit, so that
+        // back-to-back comparisons run on warm threads with warm thread-local scratch.
+        // It is NUMA-aware on machines with more than one node.
+        static Work_Stealing_Pool& shared();
+
+        void submit(Task task);
+
+        // Queue the task with the workers of one node.  Without a topology there is a
+        // single node, zero.
+        void submitTo(size_t node, Task task);
+
+        // Run one queued task on the calling thread, if there is one.  Threads that
+        // wait for tasks use this to help out rather than block.
+        bool tryRunOne();
+
+        size_t workers() const;
+        size_t nodes() const;
+
+        // Null when the pool isn't NUMA-aware.
+        const Numa_Topology* topology() const;
+
+    private:
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void run(size_t index);
+        void push(size_t index, Task task);
+        bool popOwn(size_t index, Task& task);
+        bool steal(size_t thief, Task& task);
+
+        vector<std::unique_ptr<Worker>> workers_;
+        vector<size_t> workerNode_;
+        vector<vector<size_t>> nodeWorkers_;
+        const Numa_Topology* topology_;
+        vector<std::thread> threads_;
+        std::atomic<size_t> queued_{0};
+        std::atomic<size_t> nextVictim_{0};
+        std::mutex idleMutex_;
+        std::condition_variable idle_;
+        bool stopping_ = false;
+    };
+
+    // A set of tasks that can be waited for as a whole.  Tasks may add more tasks to
+    // the group while it is being waited on.  The first exception thrown by any task
+    // is rethrown from wait().
+    class Task_Group
+    {
+    public:
+        explicit Task_Group(Work_Stealing_Pool& pool);
+        ~Task_Group();
+
+        Task_Group(const Task_Group&) = delete;
+        Task_Group& operator=(const Task_Group&) = delete;
+
+        void run(Work_Stealing_Pool::Task task);
+        void runOn(size_t node, Work_Stealing_Pool::Task task);
+        void wait();
+
+    private:
+        Work_Stealing_Pool::Task track(Work_Stealing_Pool::Task task);
+
+        Work_Stealing_Pool& pool_;
+        std::atomic<size_t> pending_{0};
+        std::mutex mutex_;
+        std::condition_variable done_;
+        std::exception_ptr error_;
+    };
+}
@@ -5,6 +5,8 @@
 #include <ostream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "Base_Encoder.hpp"
 
 namespace dna
 {
@@ -52,9 +54,11 @@ constexpr base to_base(char ch)
     }
 }
 
+// A and T are 00 and 11, C and G 01 and 10, so every base's partner is its bitwise
+// complement, four to a byte.
 constexpr std::byte complement_packed(std::byte packed)
 {
-    return packed ^ static_cast<std::byte>(0);
+    return ~packed;
 }
 
 constexpr base complement(enum base base)
@@ -82,6 +86,13 @@ constexpr packed_bases unpack(std::byte b)
             static_cast<dna::base>(b & std::byte{0x3}) });
 }
 
+// The four bases of a byte in reverse order, each complemented.
+constexpr std::byte reverse_complement_packed(std::byte packed)
+{
+    auto bases = unpack(complement_packed(packed));
+    return pack(bases[3], bases[2], bases[1], bases[0]);
+}
+
 inline std::ostream& operator<<(std::ostream& os, base v)
 {
     switch (v)
@@ -97,25 +108,10 @@ inline std::ostream& operator<<(std::ostream& os, base v)
     }
 }
 
-static std::vector<std::byte> ConvertToData(std::string str)
+// Pack a string of bases, padding the last byte with 'A'.  See EncodeBases().
+inline std::vector<std::byte> ConvertToData(std::string_view str)
 {
-    auto length = str.size();
-    auto extra = length % packed_size::value;
-    if (extra > 0)
-    {
-        std::string padding = std::string(packed_size::value - extra, 'A');
-        str += padding;
-    }
-
-    length = str.size();
-    auto numBytes = length / packed_size::value;
-    std::vector<std::byte> vec(numBytes);
-
-    for (int i = 0, j = 0; i < length; i += packed_size::value, j++)
-    {
-        vec[j] = pack(to_base(str[i]), to_base(str[i + 1]), to_base(str[i + 2]), to_base(str[i + 3]));
-    }
-    return vec;
+    return EncodeBases(str);
 }
 
 }
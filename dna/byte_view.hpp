@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <string_view>
 #include "binary_traits.hpp"
 
 using byte_view = std::basic_string_view<std::byte, detail::binary_traits>;
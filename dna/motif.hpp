@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include "base.hpp"
+#include "byte_view.hpp"
+#include "sequence_buffer.hpp"
+
+namespace dna
+{
+
+// A string literal usable as a template argument, as in motif<"TTAGGG">.
+template<std::size_t N>
+struct motif_string
+{
+	char chars[N];
+
+	constexpr motif_string(const char (&text)[N])
+	{
+		std::copy_n(text, N, chars);
+	}
+
+	constexpr std::string_view view() const
+	{
+		return std::string_view(chars, N - 1);
+	}
+};
+
+namespace detail
+{
+	constexpr bool is_bases(std::string_view text)
+	{
+		return std::all_of(text.begin(), text.end(), [](char c) {
+			return c == 'A' || c == 'C' || c == 'G' || c == 'T';
+		});
+	}
+
+	// The bases packed into the top bits of a word, first base highest, as
+	// sequence_buffer::word() has them.
+	constexpr std::uint64_t pack_word(std::string_view text)
+	{
+		std::uint64_t result = 0;
+		for (std::size_t i = 0; i < text.size(); i++)
+			result |= static_cast<std::uint64_t>(to_base(text[i])) << (62 - 2 * i);
+		return result;
+	}
+
+	constexpr std::uint64_t top_bits(std::size_t bits)
+	{
+		return bits == 0 ? 0 : ~std::uint64_t(0) << (64 - bits);
+	}
+}
+
+// A short run of bases known at compile time, with everything needed to look for it in
+// packed data worked out by the compiler: its bits and mask at each of the four phases
+// a byte can start at, the partial copies that can begin or end a run of it, and
+// scanners that test every position of a 32-base word at once, with no branches and
+// nothing set up at run time.
+template<motif_string Text>
+class motif
+{
+public:
+	static constexpr std::string_view text = Text.view();
+	static constexpr std::size_t size = text.size();
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	static_assert(size > 0 && size <= 16, "a motif is 1 to 16 bases");
+	static_assert(detail::is_bases(text), "a motif is made of A, C, G and T");
+
+	// The motif at the top of a word, and the bits it covers.
+	static constexpr std::uint64_t pattern = detail::pack_word(text);
+	static constexpr std::uint64_t mask = detail::top_bits(2 * size);
+
+	// The same, for a motif starting zero to three bases into the first byte of a word.
+	static constexpr std::array<std::uint64_t, packed_size::value> phase_patterns = {
+		pattern, pattern >> 2, pattern >> 4, pattern >> 6 };
+	static constexpr std::array<std::uint64_t, packed_size::value> phase_masks = {
+		mask, mask >> 2, mask >> 4, mask >> 6 };
+
+	// The partial copies a run can start or end with, longest first: for TTAGGG,
+	// TAGGG down to G, and TTAGG down to T.
+	static constexpr std::array<std::string_view, size - 1> leading_fragments = [] {
+		std::array<std::string_view, size - 1> result{};
+		for (std::size_t i = 0; i < result.size(); i++)
+			result[i] = text.substr(i + 1);
+		return result;
+	}();
+	static constexpr std::array<std::string_view, size - 1> trailing_fragments = [] {
+		std::array<std::string_view, size - 1> result{};
+		for (std::size_t i = 0; i < result.size(); i++)
+			result[i] = text.substr(0, size - 1 - i);
+		return result;
+	}();
+
+	// Where in a word the motif can start and still fit.
+	static constexpr std::size_t positions = sequence_buffer<byte_view>::word_bases - size + 1;
+
+	// As many whole copies back to back as fit in a word.
+	static constexpr std::size_t repeats = sequence_buffer<byte_view>::word_bases / size;
+	static constexpr std::uint64_t repeated_pattern = [] {
+		std::uint64_t result = 0;
+		for (std::size_t i = 0; i < repeats; i++)
+			result |= pattern >> (2 * size * i);
+		return result;
+	}();
+	static constexpr std::uint64_t repeated_mask = detail::top_bits(2 * size * repeats);
+
+	// Whether the word starts with the motif.
+	static constexpr bool starts(std::uint64_t word)
+	{
+		return ((word ^ pattern) & mask) == 0;
+	}
+
+	// Bit i set for each base i of the word that starts a copy of the motif.
+	static constexpr std::uint32_t matches(std::uint64_t word)
+	{
+		return [word]<std::size_t... I>(std::index_sequence<I...>) {
+			return ((static_cast<std::uint32_t>(((word ^ (pattern >> (2 * I))) & (mask >> (2 * I))) == 0) << I) | ...);
+		}(std::make_index_sequence<positions>{});
+	}
+
+	// How many whole copies the word starts with, up to repeats.
+	static constexpr std::size_t copies(std::uint64_t word)
+	{
+		return static_cast<std::size_t>(std::countl_zero((word ^ repeated_pattern) & repeated_mask)) / (2 * size);
+	}
+
+	// The first copy at or after pos, or npos.
+	template<ByteBuffer T>
+	static constexpr std::size_t find(const sequence_buffer<T>& buf, std::size_t pos = 0)
+	{
+		for (std::size_t i = pos; i < buf.size() && buf.size() - i >= size; i += positions)
+		{
+			std::uint32_t found = matches(buf.word(i)) & fitting(buf.size() - i);
+			if (found != 0)
+				return i + static_cast<std::size_t>(std::countr_zero(found));
+		}
+		return npos;
+	}
+
+	// How many copies there are, overlapping ones included.
+	template<ByteBuffer T>
+	static constexpr std::size_t count(const sequence_buffer<T>& buf)
+	{
+		std::size_t result = 0;
+		for (std::size_t i = 0; i < buf.size() && buf.size() - i >= size; i += positions)
+			result += static_cast<std::size_t>(std::popcount(matches(buf.word(i)) & fitting(buf.size() - i)));
+		return result;
+	}
+
+	// How many whole copies follow one another from pos on.
+	template<ByteBuffer T>
+	static constexpr std::size_t run(const sequence_buffer<T>& buf, std::size_t pos = 0)
+	{
+		std::size_t available = pos < buf.size() ? (buf.size() - pos) / size : 0;
+		std::size_t result = 0;
+		while (result < available)
+		{
+			std::size_t found = copies(buf.word(pos + result * size));
+			result += found;
+			if (found < repeats)
+				break;
+		}
+		return std::min(result, available);
+	}
+
+private:
+	// The start positions whose copies end before the sequence does, given how many
+	// bases are left from the start of the word.
+	static constexpr std::uint32_t fitting(std::size_t remaining)
+	{
+		std::size_t starts = remaining - size + 1;
+		return starts >= positions ? ~std::uint32_t(0) >> (32 - positions) : (std::uint32_t(1) << starts) - 1;
+	}
+};
+
+}
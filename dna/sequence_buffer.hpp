@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <compare>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 #include "base.hpp"
 
 namespace dna
@@ -21,9 +29,14 @@ class sequence_buffer_iterator
 	const sequence_buffer<T>* buf_;
 	std::size_t index_;
 public:
-	using iterator_category = std::bidirectional_iterator_tag;
+	// Bases are unpacked on the fly, so dereferencing yields a value rather than a
+	// reference, but the iterator moves and measures in constant time like a pointer.
+	using iterator_category = std::random_access_iterator_tag;
+	using iterator_concept = std::random_access_iterator_tag;
 	using value_type = base;
-	using difference_type = long;
+	using difference_type = std::ptrdiff_t;
+	using reference = base;
+	using pointer = void;
 
 	constexpr sequence_buffer_iterator() noexcept :
 			buf_(nullptr),
@@ -50,6 +63,11 @@ public:
 
 	constexpr value_type operator*() const;
 
+	constexpr value_type operator[](difference_type diff) const
+	{
+		return *(*this + diff);
+	}
+
 	constexpr sequence_buffer_iterator& operator++() noexcept
 	{
 		++index_;
@@ -63,17 +81,22 @@ public:
 		return result;
 	}
 
-	constexpr sequence_buffer_iterator& operator+=(std::size_t diff) noexcept
+	constexpr sequence_buffer_iterator& operator+=(difference_type diff) noexcept
 	{
 		index_ += diff;
 		return *this;
 	}
 
-	constexpr sequence_buffer_iterator operator+(std::size_t diff) const noexcept
+	constexpr sequence_buffer_iterator operator+(difference_type diff) const noexcept
 	{
 		return sequence_buffer_iterator(buf_, index_ + diff);
 	}
 
+	friend constexpr sequence_buffer_iterator operator+(difference_type diff, const sequence_buffer_iterator& it) noexcept
+	{
+		return it + diff;
+	}
+
 	constexpr sequence_buffer_iterator& operator--() noexcept
 	{
 		--index_;
@@ -87,32 +110,43 @@ public:
 		return result;
 	}
 
-	constexpr long operator-(const sequence_buffer_iterator& other) const noexcept
+	constexpr difference_type operator-(const sequence_buffer_iterator& other) const noexcept
 	{
-		return static_cast<long>(index_ - other.index_);
+		return static_cast<difference_type>(index_ - other.index_);
 	}
 
-	constexpr sequence_buffer_iterator& operator-=(std::size_t diff) noexcept
+	constexpr sequence_buffer_iterator& operator-=(difference_type diff) noexcept
 	{
 		index_ -= diff;
 		return *this;
 	}
 
-	constexpr sequence_buffer_iterator operator-(std::size_t diff) const noexcept
+	constexpr sequence_buffer_iterator operator-(difference_type diff) const noexcept
 	{
 		return sequence_buffer_iterator(buf_, index_ - diff);
 	}
 
-	constexpr bool operator==(const sequence_buffer_iterator& other) noexcept
+	constexpr bool operator==(const sequence_buffer_iterator& other) const noexcept
 	{
 		return buf_ == other.buf_ && index_ == other.index_;
 	}
 
-	constexpr bool operator!=(const sequence_buffer_iterator& other) noexcept
+	// Only meaningful between iterators over the same buffer.
+	constexpr auto operator<=>(const sequence_buffer_iterator& other) const noexcept
+	{
+		return index_ <=> other.index_;
+	}
+
+	// Where the iterator is, for algorithms that work a word at a time.
+	constexpr const sequence_buffer<T>* sequence() const noexcept
 	{
-		return !operator==(other);
+		return buf_;
 	}
 
+	constexpr std::size_t index() const noexcept
+	{
+		return index_;
+	}
 };
 
 template<ByteBuffer T>
@@ -120,6 +154,7 @@ class sequence_buffer
 {
 	T buffer_;
 	std::size_t size_;
+	std::size_t offset_ = 0;	// bases of the buffer before the first one of the sequence
 public:
 	using iterator = sequence_buffer_iterator<T>;
 
@@ -131,12 +166,51 @@ public:
 			size_ = static_cast<std::size_t>(buffer_.size() * packed_size::value);
 	}
 
+	// A sequence that starts the given number of bases into the buffer, partway through
+	// a byte if need be.  A size of zero means the rest of the buffer.
+	constexpr sequence_buffer(T buffer, std::size_t offset, std::size_t size) :
+			buffer_(std::forward<T>(buffer)),
+			size_(size),
+			offset_(offset)
+	{
+		if (size_ == 0)
+			size_ = static_cast<std::size_t>(buffer_.size() * packed_size::value) - offset_;
+	}
+
+	// Bases per word().
+	static constexpr std::size_t word_bases = 32;
+
 	constexpr base at(std::size_t index) const
 	{
+		index += offset_;
 		auto boffset = index / packed_size::value;
-		auto tidx = index - (boffset * packed_size::value);
+		auto shift = 2 * (packed_size::value - 1 - (index - boffset * packed_size::value));
+
+		return static_cast<base>((std::to_integer<unsigned>(static_cast<std::byte>(buffer_[boffset])) >> shift) & 0x3);
+	}
+
+	// The 32 bases starting at any index, as one word with the first base in the top two
+	// bits: the order pack() uses within a byte, carried across bytes.  Bases past the end
+	// of the sequence read as adenine, like the padding in the last byte, so kernels can
+	// run over whole words and still compare only what is there.
+	constexpr std::uint64_t word(std::size_t index) const
+	{
+		if (index >= size_)
+			return 0;
+
+		auto boffset = (offset_ + index) / packed_size::value;
+		auto phase = 2 * (offset_ + index - boffset * packed_size::value);
 
-		return unpack(buffer_[boffset])[tidx];
+		// Eight bytes from the one holding the first base, then enough of the ninth to
+		// make up for the bits shifted out of the first.
+		std::uint64_t result = load(boffset) << phase;
+		if (phase > 0)
+			result |= byte_at(boffset + sizeof(std::uint64_t)) >> (8 - phase);
+
+		auto remaining = size_ - index;
+		if (remaining < word_bases)
+			result &= ~std::uint64_t(0) << (2 * (word_bases - remaining));
+		return result;
 	}
 
 	constexpr base operator[](std::size_t index) const
@@ -149,6 +223,38 @@ public:
 		return size_;
 	}
 
+	// Where the sequence starts in the buffer, in bases.  For a subsequence of a view
+	// this is only ever the phase within the first byte, zero to three.
+	constexpr std::size_t offset() const noexcept
+	{
+		return offset_;
+	}
+
+	// Up to count bases from pos on, over the same packed data: nothing is unpacked,
+	// shifted or copied, and word() shifts the phase out on the fly.  Views are narrowed
+	// to the bytes that hold the subsequence.
+	constexpr sequence_buffer subsequence(std::size_t pos, std::size_t count = static_cast<std::size_t>(-1)) const
+	{
+		pos = std::min(pos, size_);
+		count = std::min(count, size_ - pos);
+
+		std::size_t first = offset_ + pos;
+		if constexpr (requires { { buffer_.substr(0, 0) } -> std::convertible_to<T>; })
+		{
+			std::size_t phase = first % packed_size::value;
+			std::size_t bytes = (phase + count + packed_size::value - 1) / packed_size::value;
+			sequence_buffer result(buffer_.substr(first / packed_size::value, bytes), phase, 1);
+			result.size_ = count;
+			return result;
+		}
+		else
+		{
+			sequence_buffer result(buffer_, first, 1);
+			result.size_ = count;
+			return result;
+		}
+	}
+
 	constexpr iterator begin() const noexcept
 	{
 		return iterator(this, 0);
@@ -166,7 +272,36 @@ public:
 
 	constexpr T& buffer() noexcept
 	{
-		buffer_;
+		return buffer_;
+	}
+
+private:
+	constexpr std::uint64_t byte_at(std::size_t offset) const
+	{
+		if (offset >= static_cast<std::size_t>(buffer_.size()))
+			return 0;
+		return std::to_integer<std::uint64_t>(static_cast<std::byte>(buffer_[offset]));
+	}
+
+	// Eight bytes, big-endian, as zeroes past the end of the buffer.
+	constexpr std::uint64_t load(std::size_t offset) const
+	{
+		if constexpr (requires { { buffer_.data() } -> std::convertible_to<const std::byte*>; })
+		{
+			if (!std::is_constant_evaluated() && offset + sizeof(std::uint64_t) <= static_cast<std::size_t>(buffer_.size()))
+			{
+				std::uint64_t result;
+				std::memcpy(&result, buffer_.data() + offset, sizeof(result));
+				if constexpr (std::endian::native == std::endian::little)
+					result = __builtin_bswap64(result);
+				return result;
+			}
+		}
+
+		std::uint64_t result = 0;
+		for (std::size_t i = 0; i < sizeof(std::uint64_t); i++)
+			result = (result << 8) | byte_at(offset + i);
+		return result;
 	}
 };
 
@@ -179,6 +314,82 @@ constexpr typename sequence_buffer_iterator<T>::value_type sequence_buffer_itera
 	return A;
 }
 
+// Packed-word versions of the standard algorithms, found ahead of std's for sequence
+// buffer iterators.  They compare 32 bases per step instead of unpacking each one.
+
+// Where [first1, last1) and the sequence from first2 first differ.
+template<ByteBuffer T, ByteBuffer U>
+constexpr std::pair<sequence_buffer_iterator<T>, sequence_buffer_iterator<U>>
+mismatch(sequence_buffer_iterator<T> first1, sequence_buffer_iterator<T> last1, sequence_buffer_iterator<U> first2)
+{
+	if (first1.sequence() == nullptr || first2.sequence() == nullptr)
+		return std::mismatch(first1, last1, first2, [](base a, base b) { return a == b; });
+
+	const auto& buf1 = *first1.sequence();
+	const auto& buf2 = *first2.sequence();
+	std::size_t length = static_cast<std::size_t>(last1 - first1);
+	for (std::size_t done = 0; done < length; done += sequence_buffer<T>::word_bases)
+	{
+		std::uint64_t differ = buf1.word(first1.index() + done) ^ buf2.word(first2.index() + done);
+		std::size_t bases = std::min(length - done, sequence_buffer<T>::word_bases);
+		if (bases < sequence_buffer<T>::word_bases)
+			differ &= ~std::uint64_t(0) << (2 * (sequence_buffer<T>::word_bases - bases));
+
+		if (differ != 0)
+		{
+			auto at = static_cast<std::ptrdiff_t>(done + std::countl_zero(differ) / 2);
+			return { first1 + at, first2 + at };
+		}
+	}
+	return { last1, first2 + static_cast<std::ptrdiff_t>(length) };
+}
+
+template<ByteBuffer T, ByteBuffer U>
+constexpr bool equal(sequence_buffer_iterator<T> first1, sequence_buffer_iterator<T> last1, sequence_buffer_iterator<U> first2)
+{
+	return dna::mismatch(first1, last1, first2).first == last1;
+}
+
+template<ByteBuffer T, ByteBuffer U>
+constexpr bool equal(const sequence_buffer<T>& a, const sequence_buffer<U>& b)
+{
+	return a.size() == b.size() && dna::equal(a.begin(), a.end(), b.begin());
+}
+
+// How many of the bases in [first, last) are the given one.
+template<ByteBuffer T>
+constexpr std::ptrdiff_t count(sequence_buffer_iterator<T> first, sequence_buffer_iterator<T> last, base value)
+{
+	if (first.sequence() == nullptr)
+		return std::count(first, last, value);
+
+	// XOR with the base repeated leaves 00 wherever they match; invert and pick out the
+	// pairs that are 11.
+	const std::uint64_t lows = 0x5555555555555555ull;
+	const std::uint64_t pattern = lows * static_cast<std::uint64_t>(value);
+
+	const auto& buf = *first.sequence();
+	std::size_t length = static_cast<std::size_t>(last - first);
+	std::ptrdiff_t result = 0;
+	for (std::size_t done = 0; done < length; done += sequence_buffer<T>::word_bases)
+	{
+		std::uint64_t same = ~(buf.word(first.index() + done) ^ pattern);
+		same &= (same >> 1) & lows;
+
+		std::size_t bases = std::min(length - done, sequence_buffer<T>::word_bases);
+		if (bases < sequence_buffer<T>::word_bases)
+			same &= ~std::uint64_t(0) << (2 * (sequence_buffer<T>::word_bases - bases));
+		result += std::popcount(same);
+	}
+	return result;
+}
+
+template<ByteBuffer T>
+constexpr std::ptrdiff_t count(const sequence_buffer<T>& buf, base value)
+{
+	return dna::count(buf.begin(), buf.end(), value);
+}
+
 template<ByteBuffer T>
 std::ostream& operator<<(std::ostream& os, const sequence_buffer<T>& buf)
 {
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Base_Encoder.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+// The original one-base-at-a-time packing, to check the encoder against.
+static vector<byte> PackSlowly(string str)
+{
+    while (str.size() % dna::packed_size::value != 0)
+        str += 'A';
+
+    vector<byte> data(str.size() / dna::packed_size::value);
+    for (size_t i = 0, j = 0; i < str.size(); i += dna::packed_size::value, j++)
+        data[j] = dna::pack(dna::to_base(str[i]), dna::to_base(str[i + 1]), dna::to_base(str[i + 2]), dna::to_base(str[i + 3]));
+    return data;
+}
+
+// Every character, including the ones that aren't bases, in an order that doesn't line
+// up with the 32-character blocks.
+static string Text(size_t length)
+{
+    string text;
+    for (size_t i = 0; i < length; i++)
+        text += i % 5 == 4 ? static_cast<char>(i * 37) : "ACGT"[(i * 7 + i / 11) % 4];
+    return text;
+}
+
+TEST_CASE("Encoding matches packing one base at a time", "[encoder]")
+{
+    for (size_t length : { 0, 1, 3, 4, 31, 32, 33, 64, 100, 1027 })
+    {
+        INFO("length " << length);
+        string text = Text(length);
+        REQUIRE(dna::EncodeBases(text) == PackSlowly(text));
+        REQUIRE(dna::ConvertToData(text) == PackSlowly(text));
+    }
+}
+
+TEST_CASE("Encoding in pieces matches encoding all at once", "[encoder]")
+{
+    string text = Text(1000);
+    vector<byte> expected = dna::EncodeBases(text);
+
+    for (size_t piece : { 1, 3, 5, 32, 77 })
+    {
+        INFO("piece " << piece);
+        dna::Base_Encoder encoder;
+        vector<byte> out(expected.size() + 8);
+        size_t written = 0;
+        for (size_t i = 0; i < text.size(); i += piece)
+            written += encoder.encode(std::string_view(text).substr(i, piece), out.data() + written);
+        written += encoder.finish(out.data() + written);
+
+        out.resize(written);
+        REQUIRE(out == expected);
+        REQUIRE(encoder.bases() == text.size());
+    }
+}
+
+TEST_CASE("Streams are encoded a block at a time", "[encoder]")
+{
+    string text = Text((1 << 20) + 13);
+    std::istringstream in(text);
+    std::ostringstream out;
+
+    REQUIRE(dna::EncodeStream(in, out) == text.size());
+
+    string packed = out.str();
+    vector<byte> expected = dna::EncodeBases(text);
+    REQUIRE(packed.size() == expected.size());
+    REQUIRE(std::equal(expected.begin(), expected.end(), reinterpret_cast<const byte*>(packed.data())));
+}
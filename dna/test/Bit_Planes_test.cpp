@@ -0,0 +1,114 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Bit_Planes.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static string Bases(size_t length, size_t seed)
+{
+    string text;
+    for (size_t i = 0; i < length; i++)
+        text += "ACGT"[(i * 5 + i / 7 + seed * (i % 3 == 0)) % 4];
+    return text;
+}
+
+static dna::Bit_Planes Planes(const string& text, vector<byte>& packed)
+{
+    packed = dna::ConvertToData(text);
+    return dna::Bit_Planes(dna::sequence_buffer<byte_view>(byte_view(packed.data(), packed.size()), text.size()));
+}
+
+static bool Bit(const vector<std::uint64_t>& plane, size_t i)
+{
+    return (plane[i / dna::Bit_Planes::WORD_BASES] >> (i % dna::Bit_Planes::WORD_BASES)) & 1;
+}
+
+TEST_CASE("Bit planes convert to and from packed bases", "[bitplanes]")
+{
+    for (size_t length : { 0, 1, 3, 4, 33, 63, 64, 65, 200, 1001 })
+    {
+        INFO("length " << length);
+        string text = Bases(length, 0);
+        vector<byte> packed;
+        dna::Bit_Planes planes = Planes(text, packed);
+
+        REQUIRE(planes.size() == length);
+        REQUIRE(planes.words() == (length + 63) / 64);
+        for (size_t i = 0; i < length; i++)
+            REQUIRE(dna::to_char(planes.at(i)) == text[i]);
+        REQUIRE(planes.packed() == packed);
+    }
+}
+
+TEST_CASE("Bit planes split out of phase views", "[bitplanes]")
+{
+    string text = Bases(300, 1);
+    vector<byte> packed = dna::ConvertToData(text);
+    dna::sequence_buffer<byte_view> buf(byte_view(packed.data(), packed.size()), text.size());
+
+    for (size_t pos : { 1, 2, 3, 70 })
+    {
+        INFO("pos " << pos);
+        dna::Bit_Planes planes(buf.subsequence(pos, 150));
+        REQUIRE(planes.packed() == dna::ConvertToData(text.substr(pos, 150)));
+    }
+}
+
+TEST_CASE("Bit planes pick out bases and mismatches", "[bitplanes]")
+{
+    string a = Bases(777, 0);
+    string b = Bases(777, 2);
+    vector<byte> packedA, packedB;
+    dna::Bit_Planes planesA = Planes(a, packedA);
+    dna::Bit_Planes planesB = Planes(b, packedB);
+
+    for (dna::base value : { dna::A, dna::C, dna::G, dna::T })
+    {
+        auto matches = planesA.matches(value);
+        for (size_t i = 0; i < matches.size() * 64; i++)
+            REQUIRE(Bit(matches, i) == (i < a.size() && a[i] == dna::to_char(value)));
+    }
+
+    auto mismatches = dna::MismatchMask(planesA, planesB);
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        REQUIRE(Bit(mismatches, i) == (a[i] != b[i]));
+        count += a[i] != b[i];
+    }
+    REQUIRE(count > 0);
+    REQUIRE(dna::CountMismatches(planesA, planesB) == count);
+    REQUIRE(dna::CountMismatches(planesA, planesA) == 0);
+    REQUIRE(planesA == Planes(a, packedB));
+    REQUIRE_FALSE(planesA == planesB);
+
+    dna::Bit_Planes shorter = Planes(a.substr(1), packedB);
+    REQUIRE_THROWS_AS(dna::CountMismatches(planesA, shorter), std::invalid_argument);
+}
+
+TEST_CASE("Bit planes find motifs", "[bitplanes]")
+{
+    string text = Bases(400, 0);
+    for (size_t at : { 0, 58, 60, 64, 127, 394 })
+        text.replace(at, 6, "TTAGGG");
+    text.replace(200, 4, "AAAA");
+
+    vector<byte> packed;
+    dna::Bit_Planes planes = Planes(text, packed);
+
+    auto telomeres = dna::FindMotif<"TTAGGG">(planes);
+    auto adenines = dna::FindMotif<"AAAA">(planes);
+    for (size_t i = 0; i < telomeres.size() * 64; i++)
+    {
+        INFO("base " << i);
+        REQUIRE(Bit(telomeres, i) == (i + 6 <= text.size() && text.compare(i, 6, "TTAGGG") == 0));
+        REQUIRE(Bit(adenines, i) == (i + 4 <= text.size() && text.compare(i, 4, "AAAA") == 0));
+    }
+}
@@ -2,8 +2,13 @@
 #include "base.hpp"
 #include "DNA_Stream.hpp"
 #include "Chromosome_Comparer.hpp"
+#include "String_Comparer.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <thread>
 #include <vector>
 
 using std::byte;
@@ -135,3 +140,304 @@ TEST_CASE("Tailing telomeres too", "[chromosomes]")
     string transformedS1 = dna::applyTransformations(s1.substr(0, s1.length()-3), comparison.transformations);
     REQUIRE(transformedS1 == s2);
 }
+
+TEST_CASE("Adaptive chunking finds the same substitutions", "[chromosomes]")
+{
+    string s1;
+    for (int i = 0; i < 4000; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    s2[1000] = s1[1000] == 'A' ? 'C' : 'A';
+    s2[2500] = s1[2500] == 'G' ? 'T' : 'G';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 10);
+    dna::DNA_Stream stream2(data2, 10);
+
+    dna::Comparison_Options options;
+    options.adaptiveChunking = true;
+    options.chunkLimits.minimumBytes = 8;
+    options.chunkLimits.maximumBytes = 64;
+    options.chunkLimits.initialBytes = 16;
+
+    dna::Chromosome_Comparer comparer(0, stream1, stream2, options);
+    dna::Chromosome_Comparison comparison = comparer.Compare();
+
+    REQUIRE(comparison.transformations.size() == 2);
+    REQUIRE(comparison.transformations[0].index == 1000);
+    REQUIRE(comparison.transformations[1].index == 2500);
+    REQUIRE(dna::applyTransformations(s1, comparison.transformations) == s2);
+}
+
+TEST_CASE("Comparing in segments finds what comparing in one go finds", "[chromosomes]")
+{
+    string telomeres = "GGGTTAGGGTTAGGGTTAGGG";
+    string body;
+    for (int i = 0; i < 600; i++)
+        body += "ACGT"[(i * 5 + i / 11) % 4];
+    string s1 = telomeres + body + "TTAGGGTTAGGGTTA";
+    string s2 = telomeres + body.substr(0, 150) + "C" + body.substr(151, 250) + body.substr(420) + "CATTAGGGTTAGGG";
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream whole1(data1, 8);
+    dna::DNA_Stream whole2(data2, 8);
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, whole1, whole2).Compare();
+
+    dna::DNA_Stream stream1(data1, 8);
+    dna::DNA_Stream stream2(data2, 8);
+    dna::Chromosome_Comparer comparer(0, stream1, stream2);
+    comparer.Prepare();
+    auto segments = comparer.Split(20);
+    REQUIRE(segments.size() > 4);
+    REQUIRE(segments[1].begin == 24);
+
+    // Out of order, as a pool would.
+    for (size_t i = segments.size(); i-- > 0; )
+        comparer.CompareSegment(segments[i]);
+    dna::Chromosome_Comparison comparison = comparer.Finish(segments);
+
+    REQUIRE(comparison.transformations.size() == expected.transformations.size());
+    for (size_t i = 0; i < expected.transformations.size(); i++)
+    {
+        REQUIRE(comparison.transformations[i].index == expected.transformations[i].index);
+        REQUIRE(comparison.transformations[i].type == expected.transformations[i].type);
+        REQUIRE(comparison.transformations[i].s1 == expected.transformations[i].s1);
+        REQUIRE(comparison.transformations[i].s2 == expected.transformations[i].s2);
+    }
+}
+
+TEST_CASE("Cancelled comparisons stop and resume", "[chromosomes]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 2);
+    dna::DNA_Stream stream2(data2, 2);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+    REQUIRE(expected.complete);
+
+    // A token past its deadline stops the comparison before the first chunk.
+    auto token = dna::Cancellation_Token::After(std::chrono::seconds(-1));
+    REQUIRE(token.expired());
+    dna::Comparison_Options options;
+    options.cancellation = &token;
+
+    dna::Chromosome_Comparison partial = dna::Chromosome_Comparer(0, stream1, stream2, options).Compare();
+    REQUIRE_FALSE(partial.complete);
+    REQUIRE(partial.resumeFrom == 0);
+    REQUIRE(partial.transformations.empty());
+
+    // Pretend the first half was done before the stop.
+    dna::Chromosome_Comparer comparer(0, stream1, stream2);
+    comparer.Prepare();
+    auto segments = comparer.Split(4);
+    comparer.CompareSegment(segments[0]);
+    partial.transformations = segments[0].transformations;
+    partial.resumeFrom = segments[0].end;
+    partial.resumeFromOnC2 = segments[0].end;
+
+    dna::Chromosome_Comparison resumed = dna::Chromosome_Comparer(0, stream1, stream2).Resume(partial);
+    REQUIRE(resumed.complete);
+    REQUIRE(resumed.transformations.size() == expected.transformations.size());
+    for (size_t i = 0; i < expected.transformations.size(); i++)
+    {
+        REQUIRE(resumed.transformations[i].index == expected.transformations[i].index);
+        REQUIRE(resumed.transformations[i].s1 == expected.transformations[i].s1);
+        REQUIRE(resumed.transformations[i].s2 == expected.transformations[i].s2);
+    }
+}
+
+TEST_CASE("Comparisons of streams with different chunk sizes resume where each stream stopped", "[chromosomes]")
+{
+    string s1;
+    for (int i = 0; i < 400; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    for (size_t i = 20; i < s2.size(); i += 37)
+        s2[i] = s1[i] == 'A' ? 'C' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 2);
+    dna::DNA_Stream stream2(data2, 3);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+    REQUIRE(expected.transformations.size() > 4);
+
+    // Room for a chunk's workspace and a couple of results at a time, so that every
+    // attempt stops partway through.
+    size_t c1Chars = 2 * dna::packed_size::value;
+    size_t c2Chars = 3 * dna::packed_size::value;
+    dna::Memory_Budget budget(dna::String_Comparer::WorkspaceBytes(c1Chars, c2Chars) + c1Chars + c2Chars +
+                              2 * sizeof(dna::Transformation), dna::Memory_Budget::Policy::fail);
+    dna::Comparison_Options options;
+    options.memory = &budget;
+
+    dna::Chromosome_Comparison comparison = dna::Chromosome_Comparer(0, stream1, stream2, options).Compare();
+    int attempts = 1;
+    while (!comparison.complete && attempts < 1000)
+    {
+        comparison = dna::Chromosome_Comparer(0, stream1, stream2, options).Resume(comparison);
+        attempts++;
+    }
+
+    REQUIRE(attempts > 2);
+    REQUIRE(comparison.complete);
+    REQUIRE(comparison.transformations.size() == expected.transformations.size());
+    for (size_t i = 0; i < expected.transformations.size(); i++)
+    {
+        REQUIRE(comparison.transformations[i].index == expected.transformations[i].index);
+        REQUIRE(comparison.transformations[i].type == expected.transformations[i].type);
+        REQUIRE(comparison.transformations[i].s1 == expected.transformations[i].s1);
+        REQUIRE(comparison.transformations[i].s2 == expected.transformations[i].s2);
+    }
+}
+
+
+TEST_CASE("Comparisons waiting on the memory budget don't wait on themselves", "[chromosomes]")
+{
+    string s1;
+    for (int i = 0; i < 2000; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    for (size_t i = 10; i < s2.size(); i += 23)
+        s2[i] = s1[i] == 'A' ? 'C' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 8);
+    dna::DNA_Stream stream2(data2, 8);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+    REQUIRE(expected.transformations.size() > 40);
+
+    // Every chunk's results take the budget past what the next chunk's workspace needs,
+    // so each reservation has to wait for the ones before it to stop counting.
+    size_t chars = 8 * dna::packed_size::value;
+    size_t workspace = dna::String_Comparer::WorkspaceBytes(chars, chars) + 2 * chars;
+    auto requireExpected = [&](const dna::Chromosome_Comparison& comparison) {
+        REQUIRE(comparison.complete);
+        REQUIRE(comparison.transformations.size() == expected.transformations.size());
+        for (size_t i = 0; i < expected.transformations.size(); i++)
+        {
+            REQUIRE(comparison.transformations[i].index == expected.transformations[i].index);
+            REQUIRE(comparison.transformations[i].s2 == expected.transformations[i].s2);
+        }
+    };
+
+    SECTION("in one go")
+    {
+        dna::Memory_Budget budget(workspace);
+        dna::Comparison_Options options;
+        options.memory = &budget;
+        requireExpected(dna::Chromosome_Comparer(0, stream1, stream2, options).Compare());
+        REQUIRE(budget.used() == 0);
+    }
+
+    SECTION("in segments on a pool")
+    {
+        dna::Memory_Budget budget(2 * workspace);
+        dna::Comparison_Options options;
+        options.memory = &budget;
+        dna::Work_Stealing_Pool pool(2);
+        requireExpected(dna::Chromosome_Comparer(0, stream1, stream2, options).Compare(pool, 64));
+        REQUIRE(budget.used() == 0);
+    }
+}
+
+TEST_CASE("A fan-out target that runs out of memory doesn't stop the others", "[chromosomes]")
+{
+    string s1;
+    for (int i = 0; i < 600; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    for (size_t i = 10; i < s2.size(); i += 41)
+        s2[i] = s1[i] == 'A' ? 'C' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream query(data1, 4);
+    dna::DNA_Stream small1(data2, 4);
+    dna::DNA_Stream large(data2, 32);
+    dna::DNA_Stream small2(data2, 4);
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, query, small1).Compare();
+
+    // Room for both small targets' workspaces at once, but not for the large one's.
+    size_t queryChars = 4 * dna::packed_size::value;
+    size_t smallBytes = dna::String_Comparer::WorkspaceBytes(queryChars, queryChars) + 2 * queryChars;
+    size_t largeChars = 32 * dna::packed_size::value;
+    size_t largeBytes = dna::String_Comparer::WorkspaceBytes(queryChars, largeChars) + queryChars + largeChars;
+    REQUIRE(largeBytes > 2 * smallBytes);
+    dna::Memory_Budget budget(largeBytes, dna::Memory_Budget::Policy::fail);
+    auto held = budget.reserve(largeBytes - 2 * smallBytes);
+
+    dna::Comparison_Options options;
+    options.memory = &budget;
+    vector<std::reference_wrapper<dna::DNA_Stream>> targets = { small1, large, small2 };
+    dna::Work_Stealing_Pool pool(2);
+    auto comparisons = dna::Fan_Out_Comparer(0, query, targets, options).Compare(pool);
+
+    REQUIRE_FALSE(comparisons[1].complete);
+    REQUIRE(comparisons[1].resumeFrom == 0);
+    for (size_t i : { 0, 2 })
+    {
+        REQUIRE(comparisons[i].complete);
+        REQUIRE(comparisons[i].transformations.size() == expected.transformations.size());
+        for (size_t k = 0; k < expected.transformations.size(); k++)
+            REQUIRE(comparisons[i].transformations[k].index == expected.transformations[k].index);
+    }
+}
+
+TEST_CASE("Comparisons under a memory budget don't keep their DP tables", "[chromosomes]")
+{
+    string s1;
+    for (int i = 0; i < 2000; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    for (size_t i = 10; i < s2.size(); i += 23)
+        s2[i] = s1[i] == 'A' ? 'C' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 64);
+    dna::DNA_Stream stream2(data2, 64);
+
+    size_t chars = 64 * dna::packed_size::value;
+    size_t workspace = dna::String_Comparer::WorkspaceBytes(chars, chars) + 2 * chars;
+    dna::Memory_Budget budget(workspace);
+    dna::Comparison_Options options;
+    options.memory = &budget;
+
+    // Whatever table this thread kept from before counts against nobody.
+    dna::String_Comparer().Compare(s1, s2);
+    REQUIRE(dna::String_Comparer::RetainedWorkspaceBytes() > budget.capacity());
+    dna::Chromosome_Comparer(0, stream1, stream2, options).Compare();
+    REQUIRE(dna::String_Comparer::RetainedWorkspaceBytes() == 0);
+
+    // Nor do the pool's threads, though without a budget they keep them as before.
+    dna::Work_Stealing_Pool pool(2);
+    auto largestRetained = [&] {
+        std::atomic<size_t> largest{0};
+        dna::Task_Group group(pool);
+        for (int i = 0; i < 16; i++)
+        {
+            group.run([&] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                size_t retained = dna::String_Comparer::RetainedWorkspaceBytes();
+                size_t seen = largest;
+                while (retained > seen && !largest.compare_exchange_weak(seen, retained)) { }
+            });
+        }
+        group.wait();
+        return largest.load();
+    };
+
+    dna::Chromosome_Comparer(0, stream1, stream2, options).Compare(pool, 64);
+    REQUIRE(largestRetained() == 0);
+    dna::Chromosome_Comparer(0, stream1, stream2).Compare(pool, 64);
+    REQUIRE(largestRetained() > 0);
+}
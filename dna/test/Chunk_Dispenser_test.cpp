@@ -0,0 +1,117 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Chunk_Dispenser.hpp"
+#include "DNA_Stream.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static string MakeSequence(size_t length)
+{
+    string s;
+    for (size_t i = 0; i < length; i++)
+        s += "ACGT"[(i * 11 + i / 7) % 4];
+    return s;
+}
+
+TEST_CASE("Dispensed chunks cover the stream exactly once", "[dispenser]")
+{
+    vector<byte> data = dna::ConvertToData(MakeSequence(4000));
+    dna::DNA_Stream stream(data, 16);
+    dna::Chunk_Dispenser dispenser(stream);
+
+    REQUIRE(dispenser.chunks() == (data.size() + 15) / 16);
+
+    std::array<std::atomic<size_t>, 4> counts{};
+    vector<std::atomic<int>> claimed(dispenser.chunks());
+    auto work = [&] {
+        dna::Chunk_Dispenser::Ticket ticket;
+        while (dispenser.next(ticket))
+        {
+            claimed[ticket.sequence]++;
+            for (auto b : ticket.chunk)
+                counts[static_cast<size_t>(b)]++;
+        }
+    };
+
+    vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+        threads.emplace_back(work);
+    for (auto& t : threads)
+        t.join();
+
+    for (auto& c : claimed)
+        REQUIRE(c == 1);
+    REQUIRE(counts[0] + counts[1] + counts[2] + counts[3] == 4000);
+    // The dispenser never moves the stream itself.
+    REQUIRE(stream.read().size() == 16 * dna::packed_size::value);
+}
+
+TEST_CASE("Reassembler delivers results in sequence order", "[dispenser]")
+{
+    vector<size_t> order;
+    dna::Ordered_Reassembler<string> reassembler([&](size_t sequence, string&&) {
+        order.push_back(sequence);
+    });
+
+    reassembler.submit(2, "c");
+    reassembler.submit(1, "b");
+    REQUIRE(order.empty());
+    REQUIRE(reassembler.waiting() == 2);
+
+    reassembler.submit(0, "a");
+    REQUIRE(order == vector<size_t>{ 0, 1, 2 });
+    REQUIRE(reassembler.delivered() == 3);
+    REQUIRE(reassembler.waiting() == 0);
+}
+
+TEST_CASE("Parallel scans keep stream order", "[dispenser]")
+{
+    string s = MakeSequence(1000);
+    vector<byte> data = dna::ConvertToData(s);
+    dna::DNA_Stream stream(data, 8);
+    dna::Chunk_Dispenser dispenser(stream);
+
+    string reassembled;
+    dna::ParallelScan(dispenser, 4,
+        [](const dna::Chunk_Dispenser::Ticket& ticket) {
+            string chars;
+            for (auto b : ticket.chunk)
+                chars += dna::to_char(b);
+            return chars;
+        },
+        [&](size_t, string&& chars) { reassembled += chars; });
+
+    REQUIRE(reassembled == s);
+}
+
+TEST_CASE("Parallel scans rethrow the first failure once every thread stops", "[dispenser]")
+{
+    string s = MakeSequence(4000);
+    vector<byte> data = dna::ConvertToData(s);
+    dna::DNA_Stream stream(data, 8);
+    dna::Chunk_Dispenser dispenser(stream);
+
+    std::atomic<size_t> mapped{0};
+    REQUIRE_THROWS_AS(dna::ParallelScan(dispenser, 4,
+        [&](const dna::Chunk_Dispenser::Ticket& ticket) {
+            mapped++;
+            if (ticket.sequence == 10)
+                throw std::runtime_error("bad chunk");
+            return ticket.sequence;
+        },
+        [](size_t, size_t&&) {}), std::runtime_error);
+
+    // The others gave up rather than scanning to the end.
+    REQUIRE(mapped < dispenser.chunks());
+}
+
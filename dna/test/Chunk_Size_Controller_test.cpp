@@ -0,0 +1,79 @@
+#include "catch.hpp"
+#include "Chunk_Size_Controller.hpp"
+
+#include <chrono>
+#include <cmath>
+
+using std::chrono::nanoseconds;
+
+// Simulate a chunk whose cost is a fixed overhead plus a quadratic DP term.
+static nanoseconds SimulatedCost(size_t bytes, double overhead, double dp)
+{
+    double n = static_cast<double>(bytes);
+    return nanoseconds(static_cast<long>(overhead + dp * n * n));
+}
+
+TEST_CASE("Chunk size starts at the initial size", "[chunksize]")
+{
+    dna::Chunk_Size_Controller::Limits limits;
+    limits.initialBytes = 64;
+    dna::Chunk_Size_Controller controller(limits);
+
+    REQUIRE(controller.next() == 64);
+}
+
+TEST_CASE("Chunk size converges on the cheapest size per base", "[chunksize]")
+{
+    // a/b = 40000, so the optimum is 200 bytes.
+    const double overhead = 400000;
+    const double dp = 10;
+
+    dna::Chunk_Size_Controller controller;
+    for (int i = 0; i < 100; i++)
+    {
+        size_t bytes = controller.next();
+        controller.record(bytes, SimulatedCost(bytes, overhead, dp), 0);
+    }
+
+    REQUIRE(controller.next() > 150);
+    REQUIRE(controller.next() < 270);
+}
+
+TEST_CASE("Chunk size grows with edit density", "[chunksize]")
+{
+    const double overhead = 400000;
+    const double dp = 10;
+
+    dna::Chunk_Size_Controller clean;
+    dna::Chunk_Size_Controller divergent;
+    for (int i = 0; i < 100; i++)
+    {
+        size_t bytes = clean.next();
+        clean.record(bytes, SimulatedCost(bytes, overhead, dp), 0);
+
+        bytes = divergent.next();
+        divergent.record(bytes, SimulatedCost(bytes, overhead, dp), bytes / 10);
+    }
+
+    REQUIRE(divergent.editDensity() > 0.02);
+    REQUIRE(divergent.next() > clean.next());
+}
+
+TEST_CASE("Chunk size stays within its limits", "[chunksize]")
+{
+    dna::Chunk_Size_Controller::Limits limits;
+    limits.minimumBytes = 32;
+    limits.maximumBytes = 64;
+    limits.initialBytes = 48;
+    dna::Chunk_Size_Controller controller(limits);
+
+    for (int i = 0; i < 20; i++)
+    {
+        size_t bytes = controller.next();
+        REQUIRE(bytes >= 32);
+        REQUIRE(bytes <= 64);
+        // Pure overhead: bigger is always better.
+        controller.record(bytes, nanoseconds(1000), 0);
+    }
+    REQUIRE(controller.next() == 64);
+}
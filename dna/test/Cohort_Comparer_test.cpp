@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Cohort_Comparer.hpp"
+#include "String_Comparer.hpp"
+
+#include <array>
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+using std::array;
+using std::byte;
+using std::vector;
+
+static void RequireSame(const dna::Chromosome_Comparison& a, const dna::Chromosome_Comparison& b)
+{
+    REQUIRE(a.chromosome == b.chromosome);
+    REQUIRE(a.transformations.size() == b.transformations.size());
+    for (size_t k = 0; k < a.transformations.size(); k++)
+    {
+        REQUIRE(a.transformations[k].index == b.transformations[k].index);
+        REQUIRE(a.transformations[k].type == b.transformations[k].type);
+        REQUIRE(a.transformations[k].s1 == b.transformations[k].s1);
+        REQUIRE(a.transformations[k].s2 == b.transformations[k].s2);
+    }
+}
+
+TEST_CASE("Inverted comparisons turn the second string back into the first", "[cohort]")
+{
+    vector<std::pair<string, string>> cases = {
+        { "ACGTACGTAC", "ACGTTCGTAC" },
+        { "ACGTACGTAC", "ACGTAGGCGTAC" },
+        { "TTTTACGA", "ACGTACGATTT" },
+        { "CAGCAGCAT", "CAT" },
+        { "A", "GCA" },
+    };
+
+    dna::String_Comparer comparer;
+    for (const auto& [a, b] : cases)
+    {
+        dna::Chromosome_Comparison comparison;
+        comparison.chromosome = 4;
+        comparison.transformations = comparer.Compare(a, b);
+        REQUIRE(dna::applyTransformations(a, comparison.transformations) == b);
+
+        dna::Chromosome_Comparison inverse = dna::Invert(comparison);
+        REQUIRE(inverse.chromosome == 4);
+        REQUIRE(dna::applyTransformations(b, inverse.transformations) == a);
+    }
+}
+
+TEST_CASE("Every pair of a cohort is compared once", "[cohort]")
+{
+    vector<string> genomes = {
+        "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG",
+        "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA",
+        "GGGTTAGGGTTAGGGTTAGGGCCCTAGCGAATATATAGCGAATATATTTAGGGTTAGGG",
+        "GGGTTAGGGTTAGGGTTAGGGTAGCGATTAGGGTTAGGG",
+        "GGGTTAGGGTTAGGGTTAGGGAAAAAAAAAAAAAAATTAGGGTTAGGG",
+    };
+
+    vector<vector<byte>> data;
+    vector<dna::Person> cohort;
+    for (const auto& genome : genomes)
+    {
+        data.push_back(dna::ConvertToData(genome));
+        array<dna::DNA_Stream, 23> chroms;
+        for (auto& chrom : chroms)
+            chrom = dna::DNA_Stream(data.back(), 4);
+        cohort.emplace_back(chroms);
+    }
+
+    dna::Work_Stealing_Pool pool(2);
+    dna::Cohort_Comparer comparer(cohort, 2);
+
+    std::set<std::pair<size_t, size_t>> seen;
+    comparer.Compare(pool, [&](size_t first, size_t second, const vector<dna::Chromosome_Comparison>& comparisons) {
+        REQUIRE(first < second);
+        REQUIRE(seen.insert({ first, second }).second);
+        REQUIRE(comparisons.size() == 23);
+    });
+    REQUIRE(seen.size() == genomes.size() * (genomes.size() - 1) / 2);
+
+    auto all = comparer.CompareAll(pool);
+    for (size_t i = 0; i < cohort.size(); i++)
+    {
+        REQUIRE(all[i][i].empty());
+        for (size_t j = i + 1; j < cohort.size(); j++)
+        {
+            auto expected = cohort[i].Compare(cohort[j], pool);
+            REQUIRE(all[i][j].size() == expected.size());
+            REQUIRE(all[j][i].size() == expected.size());
+            for (size_t c = 0; c < expected.size(); c++)
+            {
+                RequireSame(all[i][j][c], expected[c]);
+                RequireSame(all[j][i][c], dna::Invert(expected[c]));
+            }
+        }
+    }
+}
+
+TEST_CASE("Inverted comparisons count the other person's leading telomeres", "[cohort]")
+{
+    // The same stretch behind different numbers of leading telomeres, with substitutions,
+    // an insertion and a deletion, over several chunks.
+    string body = "ACGATCGGATCCATGCAAGTCCGATGCATCGATCGTACGGCATCGACTGACGTACGATGCCAT";
+    string trailing = "TTAGGGTTAGGGTTAGGG";
+    vector<string> genomes = {
+        "GGGTTAGGGTTAGGGTTAGGG" + body + trailing,
+        "GGGTTAGGG" + body.substr(0, 10) + "T" + body.substr(11, 30) + "GG" + body.substr(41) + trailing,
+        "GGGTTAGGGTTAGGGTTAGGGTTAGGGTTAGGG" + body.substr(0, 24) + body.substr(28, 20) + "C" + body.substr(49) + trailing,
+    };
+
+    vector<vector<byte>> data;
+    vector<dna::Person> cohort;
+    for (const auto& genome : genomes)
+    {
+        data.push_back(dna::ConvertToData(genome));
+        array<dna::DNA_Stream, 23> chroms;
+        for (auto& chrom : chroms)
+            chrom = dna::DNA_Stream(data.back(), 4);
+        cohort.emplace_back(chroms);
+    }
+
+    dna::Work_Stealing_Pool pool(2);
+    dna::Cohort_Comparer comparer(cohort, 2);
+    auto all = comparer.CompareAll(pool);
+    for (size_t i = 0; i < cohort.size(); i++)
+    {
+        for (size_t j = 0; j < cohort.size(); j++)
+        {
+            if (i == j)
+                continue;
+            auto expected = cohort[j].Compare(cohort[i], pool);
+            REQUIRE(all[j][i].size() == expected.size());
+            for (size_t c = 0; c < expected.size(); c++)
+            {
+                RequireSame(all[j][i][c], expected[c]);
+                REQUIRE(all[j][i][c].c1Start == expected[c].c1Start);
+                REQUIRE(all[j][i][c].c2Start == expected[c].c2Start);
+            }
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Chromosome_Comparer.hpp"
+#include "Comparison_Progress.hpp"
+#include "Person.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+using std::array;
+using std::byte;
+using std::vector;
+
+TEST_CASE("Chromosome comparisons report their progress", "[progress]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 2);
+    dna::DNA_Stream stream2(data2, 2);
+
+    dna::Comparison_Progress progress(4);
+    REQUIRE_FALSE(progress.snapshot(3).finished);
+    REQUIRE_THROWS_AS(progress.snapshot(4), std::invalid_argument);
+
+    dna::Comparison_Options options;
+    options.progress = &progress;
+    dna::Chromosome_Comparison comparison = dna::Chromosome_Comparer(3, stream1, stream2, options).Compare();
+
+    dna::Progress_Snapshot snapshot = progress.snapshot(3);
+    REQUIRE(snapshot.chromosome == 3);
+    REQUIRE(snapshot.finished);
+    REQUIRE(snapshot.chunks > 0);
+    REQUIRE(snapshot.c1Bases > 0);
+    REQUIRE(snapshot.c2Bases > 0);
+    REQUIRE(snapshot.transformations >= comparison.transformations.size());
+
+    // Other chromosomes are untouched.
+    REQUIRE(progress.snapshot(0).chunks == 0);
+}
+
+TEST_CASE("Progress reporters call back while a person is compared", "[progress]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGG";
+    for (int i = 0; i < 2000; i++)
+        s1 += "ACGT"[(i * 3 + i / 7) % 4];
+    string s2 = s1;
+    s2[500] = s2[500] == 'A' ? 'C' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 16);
+        chroms2[i] = dna::DNA_Stream(data2, 16);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Comparison_Progress progress(NUM_CHROMS);
+    dna::Comparison_Options options;
+    options.progress = &progress;
+
+    std::mutex mutex;
+    vector<dna::Progress_Snapshot> last;
+    int reports = 0;
+    {
+        dna::Progress_Reporter reporter(progress, std::chrono::milliseconds(1), [&](const vector<dna::Progress_Snapshot>& snapshots) {
+            std::lock_guard<std::mutex> lock(mutex);
+            last = snapshots;
+            reports++;
+        });
+
+        dna::Work_Stealing_Pool pool(2);
+        person1.Compare(person2, pool, options);
+    }
+
+    REQUIRE(reports > 0);
+    REQUIRE(last.size() == NUM_CHROMS);
+    for (const auto& snapshot : last)
+    {
+        REQUIRE(snapshot.finished);
+        REQUIRE(snapshot.c1Bases >= s1.size() - 21);
+    }
+}
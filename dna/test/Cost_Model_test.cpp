@@ -0,0 +1,48 @@
+#include "catch.hpp"
+#include "Cost_Model.hpp"
+
+#include <vector>
+
+using namespace dna;
+using std::vector;
+
+TEST_CASE("Cost grows with chromosome length and chunk size", "[cost]")
+{
+    Cost_Model model;
+
+    CHECK(model.estimate(2000, 1000, 128) == model.estimate(1000, 2000, 128));
+    CHECK(model.estimate(2000, 1000, 128) == Approx(2 * model.estimate(1000, 1000, 128)));
+    CHECK(model.estimate(1000, 1000, 256) == Approx(2 * model.estimate(1000, 1000, 128)));
+    CHECK(model.estimate(0, 0, 128) == 0);
+}
+
+TEST_CASE("Adaptive chunking is costed at its initial chunk size", "[cost]")
+{
+    Comparison_Options options;
+    options.adaptiveChunking = true;
+    options.chunkLimits.initialBytes = 64;
+    Cost_Model model(options);
+
+    CHECK(model.estimate(1000, 1000, 512) == Cost_Model().estimate(1000, 1000, 64));
+}
+
+TEST_CASE("Expensive chromosomes are cut down to the target cost", "[cost]")
+{
+    Cost_Model model;
+
+    // Cheap enough already: left whole.
+    CHECK(model.segmentBytes(1000, 50, 100, 16) == 1000);
+
+    // Four times the target: four pieces.
+    CHECK(model.segmentBytes(1000, 400, 100, 16) == 250);
+    CHECK(model.segmentBytes(1001, 400, 100, 16) == 251);
+
+    // But never below the minimum.
+    CHECK(model.segmentBytes(1000, 1e9, 100, 16) == 16);
+}
+
+TEST_CASE("Longest-first hands out the most expensive jobs first", "[cost]")
+{
+    CHECK(LongestFirst({}).empty());
+    CHECK(LongestFirst({ 3, 9, 1, 9, 4 }) == vector<size_t>{ 1, 3, 4, 0, 2 });
+}
@@ -0,0 +1,131 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "DNA_Stream.hpp"
+#include "File_Stream.hpp"
+#include "Chromosome_Comparer.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using std::byte;
+using std::vector;
+
+static string WriteTempFile(const string& name, const vector<byte>& data)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return path.string();
+}
+
+static vector<byte> ReadAll(dna::File_Stream& stream)
+{
+    vector<byte> result;
+    while (true)
+    {
+        auto buf = stream.read();
+        if (buf.size() == 0)
+            break;
+        result.insert(result.end(), buf.buffer().begin(), buf.buffer().end());
+    }
+    return result;
+}
+
+TEST_CASE("File stream delivers chunks in order", "[filestream]")
+{
+    vector<byte> data(1000);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<byte>(i * 7);
+    string path = WriteTempFile("dna_file_stream_order.bin", data);
+
+    auto backend = GENERATE(dna::Async_Backend::automatic, dna::Async_Backend::thread_pool);
+    dna::File_Stream stream(path, 37, 4, backend);
+
+    REQUIRE(stream.size() == data.size());
+    REQUIRE(ReadAll(stream) == data);
+    REQUIRE(stream.atEnd());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("File stream can seek while reads are in flight", "[filestream]")
+{
+    vector<byte> data(256);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<byte>(i);
+    string path = WriteTempFile("dna_file_stream_seek.bin", data);
+
+    dna::File_Stream stream(path, 16, 8, dna::Async_Backend::thread_pool);
+    auto first = stream.read();
+    REQUIRE(first.buffer()[0] == byte{0});
+
+    stream.seek(200);
+    auto next = stream.read();
+    REQUIRE(next.buffer().size() == 16);
+    REQUIRE(next.buffer()[0] == byte{200});
+
+    stream.advanceToEnd();
+    REQUIRE(stream.atEnd());
+    REQUIRE(stream.read().size() == 0);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("File streams compare like memory streams", "[filestream]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAACGCATAAC";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAATTTACGCATAAC";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    string path1 = WriteTempFile("dna_file_stream_c1.bin", data1);
+    string path2 = WriteTempFile("dna_file_stream_c2.bin", data2);
+
+    dna::DNA_Stream memory1(data1, 3);
+    dna::DNA_Stream memory2(data2, 3);
+    dna::Chromosome_Comparer memoryComparer(0, memory1, memory2);
+    dna::Chromosome_Comparison expected = memoryComparer.Compare();
+
+    dna::File_Stream file1(path1, 3);
+    dna::File_Stream file2(path2, 3);
+    dna::File_Chromosome_Comparer fileComparer(0, file1, file2);
+    dna::Chromosome_Comparison comparison = fileComparer.Compare();
+
+    REQUIRE(comparison.transformations.size() == expected.transformations.size());
+    for (size_t i = 0; i < expected.transformations.size(); i++)
+    {
+        REQUIRE(comparison.transformations[i].index == expected.transformations[i].index);
+        REQUIRE(comparison.transformations[i].type == expected.transformations[i].type);
+        REQUIRE(comparison.transformations[i].s1 == expected.transformations[i].s1);
+        REQUIRE(comparison.transformations[i].s2 == expected.transformations[i].s2);
+    }
+    REQUIRE(dna::applyTransformations(s1, comparison.transformations) == s2);
+
+    std::filesystem::remove(path1);
+    std::filesystem::remove(path2);
+}
+
+TEST_CASE("File stream reads can straddle read-ahead chunks", "[filestream]")
+{
+    vector<byte> data(100);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<byte>(i);
+    string path = WriteTempFile("dna_file_stream_straddle.bin", data);
+
+    dna::File_Stream stream(path, 16, 4);
+    auto small = stream.read(10);
+    REQUIRE(small.buffer().size() == 10);
+    REQUIRE(small.buffer()[9] == byte{9});
+
+    auto large = stream.read(40);
+    REQUIRE(large.buffer().size() == 40);
+    REQUIRE(large.buffer()[0] == byte{10});
+    REQUIRE(large.buffer()[39] == byte{49});
+
+    auto rest = stream.read(1000);
+    REQUIRE(rest.buffer().size() == 50);
+    REQUIRE(stream.atEnd());
+
+    std::filesystem::remove(path);
+}
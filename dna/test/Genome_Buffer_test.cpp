@@ -0,0 +1,84 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "DNA_Stream.hpp"
+#include "Genome_Buffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using std::byte;
+using std::vector;
+
+static bool IsAligned(const void* p, size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+TEST_CASE("Small genome buffers are cache aligned and padded", "[genomebuffer]")
+{
+    vector<byte> data = dna::ConvertToData("GATTACAGATTACA");
+    dna::Genome_Buffer buffer(data.data(), data.size(), dna::Allocation_Policy::huge_tlb);
+
+    REQUIRE(buffer.size() == data.size());
+    REQUIRE(IsAligned(buffer.data(), dna::CACHE_LINE_SIZE));
+    // Too small for a huge page, so the request is downgraded.
+    REQUIRE(buffer.policy() == dna::Allocation_Policy::cache_aligned);
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.data()));
+
+    // The tail of the cache line is zeroed so whole-line loads are safe.
+    for (size_t i = buffer.size(); i < dna::CACHE_LINE_SIZE; i++)
+        REQUIRE(buffer.data()[i] == byte{0});
+}
+
+TEST_CASE("Large genome buffers are huge page aligned", "[genomebuffer]")
+{
+    auto policy = GENERATE(dna::Allocation_Policy::transparent_huge_pages, dna::Allocation_Policy::huge_tlb);
+    dna::Genome_Buffer buffer(3 * dna::HUGE_PAGE_SIZE + 17, policy);
+
+    // MAP_HUGETLB needs reserved pages, which the machine may not have.  Either way
+    // the buffer must land on a huge page boundary.
+    REQUIRE(buffer.policy() != dna::Allocation_Policy::cache_aligned);
+    REQUIRE(IsAligned(buffer.data(), dna::HUGE_PAGE_SIZE));
+
+    buffer.data()[buffer.size() - 1] = byte{0x5a};
+    dna::Genome_Buffer copy(buffer);
+    REQUIRE(copy.data() != buffer.data());
+    REQUIRE(copy.data()[copy.size() - 1] == byte{0x5a});
+}
+
+TEST_CASE("DNA streams read from aligned storage", "[genomebuffer]")
+{
+    vector<byte> data = dna::ConvertToData("CACGTAACGCATCACGTAACGCAT");
+    dna::DNA_Stream stream(data, 4);
+
+    auto chunk = stream.read();
+    REQUIRE(IsAligned(chunk.buffer().data(), dna::CACHE_LINE_SIZE));
+    REQUIRE(chunk.size() == 16);
+    REQUIRE(chunk[0] == dna::C);
+}
+
+TEST_CASE("DNA streams load packed files", "[genomebuffer]")
+{
+    vector<byte> data = dna::ConvertToData("GGGTTAGGGTTAGGGTTAGGGTAACGCATAAC");
+    auto path = (std::filesystem::temp_directory_path() / "dna_genome_buffer_load.bin").string();
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    dna::DNA_Stream stream = dna::DNA_Stream::FromFile(path, 3);
+    REQUIRE(stream.size() == data.size());
+
+    vector<byte> loaded;
+    while (!stream.atEnd())
+    {
+        auto chunk = stream.read();
+        loaded.insert(loaded.end(), chunk.buffer().begin(), chunk.buffer().end());
+    }
+    REQUIRE(loaded == data);
+
+    std::filesystem::remove(path);
+}
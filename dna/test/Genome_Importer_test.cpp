@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "DNA_Stream.hpp"
+#include "File_Stream.hpp"
+#include "Genome_Importer.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static string TempPath(const string& name)
+{
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static void WriteText(const string& path, const string& text)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << text;
+}
+
+static string Bases(size_t length, size_t seed)
+{
+    string text;
+    for (size_t i = 0; i < length; i++)
+        text += "ACGT"[(i * 7 + i / 5 + seed) % 4];
+    return text;
+}
+
+TEST_CASE("Imported chromosomes load as packed streams", "[importer]")
+{
+    dna::Work_Stealing_Pool pool(3);
+    string text = Bases(1001, 0);
+    string textPath = TempPath("dna_import_chromosome.txt");
+    string packedPath = TempPath("dna_import_chromosome.bin");
+    WriteText(textPath, text + "\n");
+
+    // Segments of eight bases, so there are plenty of them.
+    dna::Packed_Chromosome_Info info = dna::ImportChromosome(textPath, packedPath, pool, 8);
+    REQUIRE(info.bases == 1001);
+    REQUIRE(info.padding == 3);
+
+    dna::Packed_Chromosome_Info read = dna::ReadChromosomeInfo(packedPath);
+    REQUIRE(read.bases == info.bases);
+    REQUIRE(read.padding == info.padding);
+
+    vector<byte> expected = dna::ConvertToData(text);
+    dna::DNA_Stream stream = dna::DNA_Stream::FromFile(packedPath, 64);
+    REQUIRE(stream.size() == expected.size());
+    auto view = stream.view(0, stream.size());
+    REQUIRE(vector<byte>(view.buffer().begin(), view.buffer().end()) == expected);
+
+    dna::File_Stream file(packedPath, 64);
+    REQUIRE(file.size() == expected.size());
+
+    std::filesystem::remove(textPath);
+    std::filesystem::remove(packedPath);
+    std::filesystem::remove(dna::MetadataPath(packedPath));
+}
+
+TEST_CASE("A person's chromosomes are imported together", "[importer]")
+{
+    dna::Work_Stealing_Pool pool(2);
+    vector<string> texts{ Bases(100, 1), Bases(37, 2), "" };
+    vector<string> textPaths, packedPaths;
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        textPaths.push_back(TempPath("dna_import_person_" + std::to_string(i) + ".txt"));
+        packedPaths.push_back(TempPath("dna_import_person_" + std::to_string(i) + ".bin"));
+        WriteText(textPaths[i], texts[i]);
+    }
+
+    auto infos = dna::ImportChromosomes(textPaths, packedPaths, pool, 16);
+    REQUIRE(infos.size() == texts.size());
+    for (size_t i = 0; i < texts.size(); i++)
+    {
+        INFO("chromosome " << i);
+        REQUIRE(infos[i].bases == texts[i].size());
+
+        vector<byte> expected = dna::ConvertToData(texts[i]);
+        REQUIRE(std::filesystem::file_size(packedPaths[i]) == expected.size());
+        if (!expected.empty())
+        {
+            dna::DNA_Stream stream = dna::DNA_Stream::FromFile(packedPaths[i]);
+            auto view = stream.view(0, stream.size());
+            REQUIRE(vector<byte>(view.buffer().begin(), view.buffer().end()) == expected);
+        }
+
+        std::filesystem::remove(textPaths[i]);
+        std::filesystem::remove(packedPaths[i]);
+        std::filesystem::remove(dna::MetadataPath(packedPaths[i]));
+    }
+}
+
+TEST_CASE("Importing needs a packed file for every text file", "[importer]")
+{
+    dna::Work_Stealing_Pool pool(1);
+    REQUIRE_THROWS_AS(dna::ImportChromosomes({ "a.txt" }, {}, pool), std::invalid_argument);
+    REQUIRE_THROWS_AS(dna::ReadChromosomeInfo(TempPath("dna_import_missing.bin")), std::invalid_argument);
+}
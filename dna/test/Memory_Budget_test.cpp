@@ -0,0 +1,127 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Chromosome_Comparer.hpp"
+#include "Memory_Budget.hpp"
+#include "String_Comparer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using std::byte;
+using std::vector;
+
+TEST_CASE("Reservations are held until released", "[memory]")
+{
+    dna::Memory_Budget budget(100);
+    {
+        dna::Memory_Reservation a = budget.reserve(60);
+        REQUIRE(budget.used() == 60);
+
+        auto b = budget.tryReserve(50);
+        REQUIRE_FALSE(b.has_value());
+
+        dna::Memory_Reservation c = std::move(a);
+        REQUIRE(c.bytes() == 60);
+        REQUIRE(a.bytes() == 0);
+        REQUIRE(budget.used() == 60);
+
+        c.release();
+        REQUIRE(budget.used() == 0);
+
+        b = budget.tryReserve(50);
+        REQUIRE(b.has_value());
+        REQUIRE(budget.used() == 50);
+    }
+    REQUIRE(budget.used() == 0);
+    REQUIRE(budget.peak() == 60);
+}
+
+TEST_CASE("Reservations larger than the whole budget are an error", "[memory]")
+{
+    dna::Memory_Budget budget(100);
+    REQUIRE_THROWS_AS(budget.reserve(101), std::invalid_argument);
+}
+
+TEST_CASE("The fail policy throws when a reservation doesn't fit", "[memory]")
+{
+    dna::Memory_Budget budget(100, dna::Memory_Budget::Policy::fail);
+    dna::Memory_Reservation held = budget.reserve(80);
+    REQUIRE_THROWS_AS(budget.reserve(30), dna::Memory_Budget_Exceeded);
+    REQUIRE(budget.used() == 80);
+}
+
+TEST_CASE("The wait policy holds reservations until there is room", "[memory]")
+{
+    dna::Memory_Budget budget(100);
+    dna::Memory_Reservation held = budget.reserve(80);
+
+    std::atomic<bool> reserved{false};
+    std::thread waiter([&] {
+        dna::Memory_Reservation mine = budget.reserve(30);
+        reserved = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(reserved);
+
+    held.release();
+    waiter.join();
+    REQUIRE(reserved);
+    REQUIRE(budget.used() == 0);
+}
+
+TEST_CASE("Growing a reservation never waits", "[memory]")
+{
+    dna::Memory_Budget budget(100, dna::Memory_Budget::Policy::fail);
+    dna::Memory_Reservation results(budget);
+    results.grow(150);
+    REQUIRE(budget.used() == 150);
+    REQUIRE_THROWS_AS(budget.reserve(1), dna::Memory_Budget_Exceeded);
+
+    results.release();
+    REQUIRE(budget.used() == 0);
+}
+
+TEST_CASE("Comparisons that run out of memory stop and resume", "[memory]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 2);
+    dna::DNA_Stream stream2(data2, 2);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+
+    // Room for a chunk's workspace and all of the results, but somebody else has it.
+    size_t chars = 2 * dna::packed_size::value;
+    dna::Memory_Budget budget(dna::String_Comparer::WorkspaceBytes(chars, chars) + 2 * chars +
+                              expected.transformations.size() * sizeof(dna::Transformation),
+                              dna::Memory_Budget::Policy::fail);
+    dna::Comparison_Options options;
+    options.memory = &budget;
+
+    dna::Chromosome_Comparison partial;
+    {
+        dna::Memory_Reservation elsewhere = budget.reserve(budget.capacity());
+        partial = dna::Chromosome_Comparer(0, stream1, stream2, options).Compare();
+        REQUIRE_FALSE(partial.complete);
+        REQUIRE(partial.resumeFrom == 0);
+    }
+
+    dna::Chromosome_Comparison resumed = dna::Chromosome_Comparer(0, stream1, stream2, options).Resume(partial);
+    REQUIRE(resumed.complete);
+    REQUIRE(budget.used() == 0);
+    REQUIRE(budget.peak() > 0);
+    REQUIRE(resumed.transformations.size() == expected.transformations.size());
+    for (size_t i = 0; i < expected.transformations.size(); i++)
+    {
+        REQUIRE(resumed.transformations[i].index == expected.transformations[i].index);
+        REQUIRE(resumed.transformations[i].s1 == expected.transformations[i].s1);
+        REQUIRE(resumed.transformations[i].s2 == expected.transformations[i].s2);
+    }
+}
@@ -0,0 +1,76 @@
+#include "catch.hpp"
+#include "Genome_Buffer.hpp"
+#include "Numa_Topology.hpp"
+#include "Work_Stealing_Pool.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using std::vector;
+
+TEST_CASE("CPU lists are parsed", "[numa]")
+{
+    REQUIRE(dna::ParseCpuList("0") == vector<int>{ 0 });
+    REQUIRE(dna::ParseCpuList("0-3,8,10-11\n") == vector<int>{ 0, 1, 2, 3, 8, 10, 11 });
+    REQUIRE(dna::ParseCpuList("").empty());
+}
+
+TEST_CASE("Topologies are read from sysfs", "[numa]")
+{
+    auto root = std::filesystem::temp_directory_path() / "dna_numa_test";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "node1");
+    std::filesystem::create_directories(root / "node0");
+    std::filesystem::create_directories(root / "node2");       // memory only
+    std::filesystem::create_directories(root / "power");
+    std::ofstream(root / "node0" / "cpulist") << "0-3\n";
+    std::ofstream(root / "node1" / "cpulist") << "4-7\n";
+    std::ofstream(root / "node2" / "cpulist") << "\n";
+
+    dna::Numa_Topology topology(root.string());
+    REQUIRE(topology.nodes() == 2);
+    REQUIRE(topology.nodeId(0) == 0);
+    REQUIRE(topology.nodeId(1) == 1);
+    REQUIRE(topology.cpus(1) == vector<int>{ 4, 5, 6, 7 });
+    REQUIRE_THROWS_AS(topology.cpus(2), std::invalid_argument);
+
+    // Without sysfs, one node with every CPU.
+    dna::Numa_Topology flat((root / "missing").string());
+    REQUIRE(flat.nodes() == 1);
+    REQUIRE_FALSE(flat.cpus(0).empty());
+
+    REQUIRE(dna::Numa_Topology::system().nodes() >= 1);
+}
+
+TEST_CASE("NUMA-aware pools run tasks on every node", "[numa]")
+{
+    // Pretend the machine's CPUs form two nodes.
+    auto root = std::filesystem::temp_directory_path() / "dna_numa_pool_test";
+    std::filesystem::remove_all(root);
+    const auto& real = dna::Numa_Topology::system().cpus(0);
+    for (int node = 0; node < 2; node++)
+    {
+        std::filesystem::create_directories(root / ("node" + std::to_string(node)));
+        std::ofstream(root / ("node" + std::to_string(node)) / "cpulist") << real[node % real.size()] << "\n";
+    }
+    dna::Numa_Topology topology(root.string());
+
+    dna::Work_Stealing_Pool pool(4, &topology);
+    REQUIRE(pool.nodes() == 2);
+    REQUIRE(pool.topology() == &topology);
+
+    std::atomic<int> sum{0};
+    dna::Task_Group group(pool);
+    for (int i = 1; i <= 100; i++)
+        group.runOn(i % 2, [&sum, i] { sum += i; });
+    group.wait();
+    REQUIRE(sum == 5050);
+
+    // Binding is best effort; it must never disturb the data.
+    dna::Genome_Buffer buffer(3 * 4096 + 17);
+    buffer.data()[5000] = std::byte{42};
+    buffer.bindToNode(topology.nodeId(0));
+    REQUIRE(buffer.data()[5000] == std::byte{42});
+}
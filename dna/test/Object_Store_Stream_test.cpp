@@ -0,0 +1,217 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Chunk_Cache.hpp"
+#include "Chromosome_Comparer.hpp"
+#include "Object_Store.hpp"
+#include "Object_Store_Stream.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using std::byte;
+using std::vector;
+
+// Counts the ranged GETs that actually reach the store.
+class counting_store : public dna::Object_Store
+{
+    dna::Local_Object_Store inner_;
+public:
+    std::atomic<int> gets{0};
+
+    counting_store(const string& root, std::chrono::microseconds latency) : inner_(root, latency)
+    { }
+
+    size_t size(const string& key) override
+    {
+        return inner_.size(key);
+    }
+
+    size_t get(const string& key, size_t offset, size_t length, std::byte* out) override
+    {
+        gets++;
+        return inner_.get(key, offset, length, out);
+    }
+};
+
+// Returns fewer bytes than asked for until told not to.
+class short_store : public dna::Object_Store
+{
+    dna::Local_Object_Store inner_;
+public:
+    bool shortReads = true;
+
+    explicit short_store(const string& root) : inner_(root)
+    { }
+
+    size_t size(const string& key) override
+    {
+        return inner_.size(key);
+    }
+
+    size_t get(const string& key, size_t offset, size_t length, std::byte* out) override
+    {
+        return inner_.get(key, offset, shortReads ? length / 2 : length, out);
+    }
+};
+
+static string StoreRoot()
+{
+    auto root = std::filesystem::temp_directory_path() / "dna_object_store_test";
+    std::filesystem::create_directories(root);
+    return root.string();
+}
+
+static void PutObject(const string& root, const string& key, const vector<byte>& data)
+{
+    std::ofstream out(root + "/" + key, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+}
+
+static vector<byte> Drain(dna::Object_Store_Stream& stream, size_t readSize)
+{
+    vector<byte> result;
+    while (!stream.atEnd())
+    {
+        auto buf = stream.read(readSize);
+        result.insert(result.end(), buf.buffer().begin(), buf.buffer().end());
+    }
+    return result;
+}
+
+TEST_CASE("Object store streams read whole objects", "[objectstore]")
+{
+    string root = StoreRoot();
+    vector<byte> data(300);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<byte>(i * 3);
+    PutObject(root, "person1-chr1", data);
+
+    auto store = std::make_shared<dna::Local_Object_Store>(root);
+    dna::Object_Store_Stream stream(store, "person1-chr1", 32);
+
+    REQUIRE(stream.size() == data.size());
+    // Reads smaller and larger than the fetch size.
+    REQUIRE(Drain(stream, 7) == data);
+    stream.seek(0);
+    REQUIRE(Drain(stream, 50) == data);
+
+    stream.seek(290);
+    REQUIRE(stream.read().size() == 10 * dna::packed_size::value);
+    REQUIRE(stream.atEnd());
+}
+
+TEST_CASE("Repeated reads of a popular object hit the shared cache", "[objectstore]")
+{
+    string root = StoreRoot();
+    vector<byte> data(256, byte{0x1b});
+    PutObject(root, "reference-chr2", data);
+
+    auto store = std::make_shared<counting_store>(root, std::chrono::microseconds(200));
+    auto cache = std::make_shared<dna::Chunk_Cache>(1024);
+
+    dna::Object_Store_Stream first(store, "reference-chr2", 64, cache);
+    REQUIRE(Drain(first, 64) == data);
+    REQUIRE(store->gets == 4);
+
+    // A second stream over the same object never goes back to storage.
+    dna::Object_Store_Stream second(store, "reference-chr2", 64, cache);
+    REQUIRE(Drain(second, 64) == data);
+    REQUIRE(store->gets == 4);
+
+    auto stats = cache->statistics();
+    REQUIRE(stats.misses == 4);
+    REQUIRE(stats.hits == 4);
+    REQUIRE(stats.bytes == 256);
+}
+
+TEST_CASE("The chunk cache evicts the least recently used chunks", "[objectstore]")
+{
+    dna::Chunk_Cache cache(2 * 64);
+    int loads = 0;
+    auto load = [&] { loads++; return dna::Chunk_Cache::Chunk(64); };
+
+    cache.get({ 0, "a", 64, 0 }, load);
+    cache.get({ 0, "a", 64, 1 }, load);
+    cache.get({ 0, "a", 64, 0 }, load);     // 0 is now the most recent
+    cache.get({ 0, "a", 64, 2 }, load);     // evicts 1
+    REQUIRE(loads == 3);
+
+    cache.get({ 0, "a", 64, 0 }, load);
+    REQUIRE(loads == 3);
+    cache.get({ 0, "a", 64, 1 }, load);
+    REQUIRE(loads == 4);
+
+    auto stats = cache.statistics();
+    REQUIRE(stats.evictions == 2);
+    REQUIRE(stats.bytes <= cache.capacity());
+}
+
+TEST_CASE("Object store streams compare like memory streams", "[objectstore]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA";
+    string root = StoreRoot();
+    PutObject(root, "s1", dna::ConvertToData(s1));
+    PutObject(root, "s2", dna::ConvertToData(s2));
+
+    auto store = std::make_shared<dna::Local_Object_Store>(root);
+    auto cache = std::make_shared<dna::Chunk_Cache>(1 << 20);
+    dna::Object_Store_Stream stream1(store, "s1", 4, cache);
+    dna::Object_Store_Stream stream2(store, "s2", 4, cache);
+
+    dna::Object_Store_Chromosome_Comparer comparer(0, stream1, stream2);
+    dna::Chromosome_Comparison comparison = comparer.Compare();
+
+    REQUIRE(comparison.transformations.size() == 3);
+    REQUIRE(dna::applyTransformations(s1.substr(0, s1.length() - 3), comparison.transformations) == s2);
+}
+
+TEST_CASE("Short reads from the store are errors and are not cached", "[objectstore]")
+{
+    string root = StoreRoot();
+    vector<byte> data(256);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = static_cast<byte>(i);
+    PutObject(root, "short", data);
+
+    auto store = std::make_shared<short_store>(root);
+    auto cache = std::make_shared<dna::Chunk_Cache>(1 << 20);
+    dna::Object_Store_Stream stream(store, "short", 64, cache);
+    REQUIRE_THROWS_AS(stream.read(), std::runtime_error);
+
+    store->shortReads = false;
+    stream.seek(0);
+    REQUIRE(Drain(stream, 64) == data);
+}
+
+TEST_CASE("The chunk cache tells stores apart by identity, not address", "[objectstore]")
+{
+    string root = StoreRoot();
+    std::filesystem::create_directories(root + "/first");
+    std::filesystem::create_directories(root + "/second");
+    PutObject(root + "/first", "chr", vector<byte>(64, byte{ 1 }));
+    PutObject(root + "/second", "chr", vector<byte>(64, byte{ 2 }));
+
+    auto cache = std::make_shared<dna::Chunk_Cache>(1 << 20);
+    std::uint64_t firstId;
+    {
+        auto first = std::make_shared<dna::Local_Object_Store>(root + "/first");
+        firstId = first->id();
+        dna::Object_Store_Stream stream(first, "chr", 64, cache);
+        REQUIRE(Drain(stream, 64) == vector<byte>(64, byte{ 1 }));
+    }
+
+    // Quite likely at the same address as the first store, now freed.
+    auto second = std::make_shared<dna::Local_Object_Store>(root + "/second");
+    REQUIRE(second->id() != firstId);
+    dna::Object_Store_Stream stream(second, "chr", 64, cache);
+    REQUIRE(Drain(stream, 64) == vector<byte>(64, byte{ 2 }));
+}
+
@@ -0,0 +1,157 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "DNA_Stream.hpp"
+#include "Chromosome_Comparer.hpp"
+#include "Packed_Transformations.hpp"
+#include "Work_Stealing_Pool.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static_assert(std::random_access_iterator<dna::Packed_Transformations::const_iterator>);
+
+static string ToString(const dna::sequence_buffer<byte_view>& bases)
+{
+    std::ostringstream out;
+    out << bases;
+    return out.str();
+}
+
+static void RequireSame(const vector<dna::Transformation>& a, const vector<dna::Transformation>& b)
+{
+    REQUIRE(a.size() == b.size());
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        REQUIRE(a[i].index == b[i].index);
+        REQUIRE(a[i].type == b[i].type);
+        REQUIRE(a[i].s1 == b[i].s1);
+        REQUIRE(a[i].s2 == b[i].s2);
+    }
+}
+
+TEST_CASE("Packed transformations read back as they went in", "[packed]")
+{
+    vector<dna::Transformation> transformations = {
+        dna::Transformation(3, dna::SUBSTITUTION, "A", "G"),
+        dna::Transformation(10, dna::INSERTION, "CATTAG"),
+        dna::Transformation(17, dna::DELETION, "T"),
+        dna::Transformation(20, dna::SUBSTITUTION, "GGC", "TTAGGGA"),
+        dna::Transformation(40, dna::INSERTION, ""),
+    };
+
+    dna::Packed_Transformations packed(transformations);
+    REQUIRE(packed.size() == transformations.size());
+    RequireSame(packed.unpack(), transformations);
+
+    // The proxies read in place, with their strings as views of the packed bases.
+    auto t = packed[3];
+    REQUIRE(t.index() == 20);
+    REQUIRE(t.type() == dna::SUBSTITUTION);
+    REQUIRE(ToString(t.s1()) == "GGC");
+    REQUIRE(ToString(t.s2()) == "TTAGGGA");
+    REQUIRE(packed[1].s2().size() == 0);
+
+    std::ostringstream viewed, plain;
+    viewed << packed[1];
+    plain << transformations[1];
+    REQUIRE(viewed.str() == plain.str());
+
+    size_t insertions = 0;
+    for (auto transformation : packed)
+        insertions += transformation.type() == dna::INSERTION;
+    REQUIRE(insertions == 2);
+    REQUIRE(packed.end() - packed.begin() == 5);
+    REQUIRE(packed.begin()[2].index() == 17);
+
+    REQUIRE_THROWS_AS(packed.emplace_back(50, dna::INSERTION, "CANT"), std::invalid_argument);
+    REQUIRE(packed.size() == transformations.size());
+}
+
+TEST_CASE("Packed SNPs take a fraction of the memory", "[packed]")
+{
+    const size_t count = 100000;
+    vector<dna::Transformation> snps;
+    snps.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        snps.emplace_back(i * 17, dna::SUBSTITUTION, string(1, "ACGT"[i % 4]), string(1, "ACGT"[(i + 1) % 4]));
+
+    dna::Packed_Transformations packed(snps);
+    REQUIRE(packed.memoryBytes() * 3 < count * sizeof(dna::Transformation));
+    RequireSame(packed.unpack(), snps);
+}
+
+TEST_CASE("Comparisons can be kept packed", "[packed]")
+{
+    string s1;
+    for (int i = 0; i < 2000; i++)
+        s1 += "ACGT"[(i * 7 + i / 13) % 4];
+    string s2 = s1;
+    s2[300] = s1[300] == 'A' ? 'C' : 'A';
+    s2[1500] = s1[1500] == 'G' ? 'T' : 'G';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 10);
+    dna::DNA_Stream stream2(data2, 10);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+    REQUIRE(expected.transformations.size() == 2);
+
+    dna::Comparison_Options options;
+    options.packTransformations = true;
+    dna::Chromosome_Comparison comparison = dna::Chromosome_Comparer(0, stream1, stream2, options).Compare();
+    REQUIRE(comparison.transformations.empty());
+    REQUIRE(comparison.packedTransformations.size() == 2);
+
+    dna::Chromosome_Comparison inverse = dna::Invert(comparison);
+    REQUIRE(inverse.transformations.empty());
+    inverse.unpack();
+    RequireSame(inverse.transformations, dna::Invert(expected).transformations);
+
+    comparison.unpack();
+    REQUIRE(comparison.packedTransformations.empty());
+    RequireSame(comparison.transformations, expected.transformations);
+}
+
+TEST_CASE("Comparisons are packed a segment at a time", "[packed]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGG";
+    for (int i = 0; i < 3000; i++)
+        s1 += "ACGT"[(i * 5 + i / 11) % 4];
+    string s2 = s1.substr(0, 700) + "CAT" + s1.substr(700, 1200) + s1.substr(1960);
+    for (size_t i = 50; i < s2.size(); i += 211)
+        s2[i] = s2[i] == 'A' ? 'G' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    dna::DNA_Stream stream1(data1, 8);
+    dna::DNA_Stream stream2(data2, 8);
+    dna::Work_Stealing_Pool pool(2);
+
+    dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare(pool, 64);
+    REQUIRE(expected.transformations.size() > 10);
+
+    dna::Comparison_Options options;
+    options.packTransformations = true;
+    dna::Chromosome_Comparison comparison = dna::Chromosome_Comparer(0, stream1, stream2, options).Compare(pool, 64);
+    REQUIRE(comparison.transformations.empty());
+    RequireSame(comparison.packedTransformations.unpack(), expected.transformations);
+
+    // And from a fan-out, and from a short target that runs out first.
+    vector<byte> half(data2.begin(), data2.begin() + data2.size() / 2);
+    dna::DNA_Stream shorter(half, 8);
+    vector<std::reference_wrapper<dna::DNA_Stream>> targets = { stream2, shorter };
+    auto fannedOut = dna::Fan_Out_Comparer(0, stream1, targets, options).Compare(pool);
+    RequireSame(fannedOut[0].packedTransformations.unpack(), expected.transformations);
+    dna::Chromosome_Comparison againstShorter = dna::Chromosome_Comparer(0, stream1, shorter).Compare();
+    REQUIRE(fannedOut[1].transformations.empty());
+    RequireSame(fannedOut[1].packedTransformations.unpack(), againstShorter.transformations);
+}
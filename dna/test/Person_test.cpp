@@ -4,7 +4,9 @@
 #include "DNA_Stream.hpp"
 #include "Chromosome_Comparison.hpp"
 
+#include <chrono>
 #include <cstddef>
+#include <thread>
 #include <vector>
 #include <array>
 
@@ -67,3 +69,331 @@ TEST_CASE("Compare two people", "[person]")
         REQUIRE(transformedS1 == s2);
     }
 }
+
+TEST_CASE("One pool serves many comparisons", "[person]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 4);
+        chroms2[i] = dna::DNA_Stream(data2, 4);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Work_Stealing_Pool pool(3);
+    for (int round = 0; round < 5; round++)
+    {
+        vector<dna::Chromosome_Comparison> comparisons = person1.Compare(person2, pool);
+        REQUIRE(comparisons.size() == 23);
+        for (const auto& comparison : comparisons)
+        {
+            REQUIRE(comparison.transformations.size() == 3);
+            REQUIRE(dna::applyTransformations(s1.substr(0, s1.length() - 3), comparison.transformations) == s2);
+        }
+    }
+}
+
+TEST_CASE("Compare one person against many", "[person]")
+{
+    string query = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    vector<string> others = {
+        "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTTAGGGTTAGGGTTAGGGTTA",
+        "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG",
+        "GGGTTAGGGTTAGGGTTAGGGCCCTAGCGAATATATAGCGAATATATTTAGGGTTAGGG",
+        "GGGTTAGGGTTAGGGTTAGGGTAGCGATTAGGGTTAGGG",
+    };
+
+    vector<byte> queryData = dna::ConvertToData(query);
+    array<dna::DNA_Stream, 23> queryChroms;
+    for (auto& chrom : queryChroms)
+        chrom = dna::DNA_Stream(queryData, 2);
+    dna::Person person(queryChroms);
+
+    vector<vector<byte>> data;
+    vector<dna::Person> cohort;
+    for (const auto& other : others)
+    {
+        data.push_back(dna::ConvertToData(other));
+        array<dna::DNA_Stream, 23> chroms;
+        for (auto& chrom : chroms)
+            chrom = dna::DNA_Stream(data.back(), 3);
+        cohort.emplace_back(chroms);
+    }
+
+    dna::Work_Stealing_Pool pool(2);
+    auto comparisons = person.CompareAgainst(cohort, pool);
+    REQUIRE(comparisons.size() == others.size());
+
+    for (size_t j = 0; j < cohort.size(); j++)
+    {
+        auto expected = person.Compare(cohort[j], pool);
+        REQUIRE(comparisons[j].size() == expected.size());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            REQUIRE(comparisons[j][i].chromosome == expected[i].chromosome);
+            REQUIRE(comparisons[j][i].transformations.size() == expected[i].transformations.size());
+            for (size_t k = 0; k < expected[i].transformations.size(); k++)
+            {
+                REQUIRE(comparisons[j][i].transformations[k].index == expected[i].transformations[k].index);
+                REQUIRE(comparisons[j][i].transformations[k].type == expected[i].transformations[k].type);
+                REQUIRE(comparisons[j][i].transformations[k].s1 == expected[i].transformations[k].s1);
+                REQUIRE(comparisons[j][i].transformations[k].s2 == expected[i].transformations[k].s2);
+            }
+        }
+    }
+}
+
+TEST_CASE("One person can be in several comparisons at once", "[person]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGG";
+    for (int i = 0; i < 2000; i++)
+        s1 += "ACGT"[(i * 7 + i / 5) % 4];
+    // The second ends early, so finishing reads the rest of the first from its stream.
+    string s2 = "GGGTTAGGG" + s1.substr(21, 900) + "CAT" + s1.substr(921, 300);
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 2);
+        chroms2[i] = dna::DNA_Stream(data2, 2);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Work_Stealing_Pool pool(4);
+    auto expected = person1.Compare(person2, pool);
+
+    // Every call seeks the same people's streams, each from its own thread.
+    vector<vector<dna::Chromosome_Comparison>> results(8);
+    vector<std::thread> threads;
+    for (size_t t = 0; t < results.size(); t++)
+        threads.emplace_back([&, t] { results[t] = person1.Compare(person2, pool); });
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& comparisons : results)
+    {
+        REQUIRE(comparisons.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            REQUIRE(comparisons[i].transformations.size() == expected[i].transformations.size());
+            for (size_t k = 0; k < expected[i].transformations.size(); k++)
+                REQUIRE(comparisons[i].transformations[k].index == expected[i].transformations[k].index);
+        }
+    }
+}
+
+TEST_CASE("Person comparisons can be cancelled and resumed", "[person]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGG";
+    for (int i = 0; i < 3000; i++)
+        s1 += "ACGT"[(i * 7 + i / 5) % 4];
+    string s2 = s1;
+    for (size_t i = 40; i < s2.size(); i += 97)
+        s2[i] = s2[i] == 'A' ? 'G' : 'A';
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 16);
+        chroms2[i] = dna::DNA_Stream(data2, 16);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Work_Stealing_Pool pool(2);
+    auto expected = person1.Compare(person2, pool);
+
+    // Wherever the cancellation lands, resuming gives the same answer.
+    dna::Cancellation_Token token;
+    dna::Comparison_Options options;
+    options.cancellation = &token;
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        token.cancel();
+    });
+    auto partial = person1.Compare(person2, pool, options);
+    canceller.join();
+
+    auto resumed = person1.Resume(person2, partial, pool);
+    REQUIRE(resumed.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); i++)
+    {
+        REQUIRE(resumed[i].complete);
+        REQUIRE(resumed[i].transformations.size() == expected[i].transformations.size());
+        for (size_t k = 0; k < expected[i].transformations.size(); k++)
+            REQUIRE(resumed[i].transformations[k].index == expected[i].transformations[k].index);
+    }
+}
+
+TEST_CASE("Comparisons against many honour the options", "[person]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGG";
+    for (int i = 0; i < 3000; i++)
+        s1 += "ACGT"[(i * 7 + i / 5) % 4];
+    vector<string> others = { s1, s1, s1.substr(0, 1800) };
+    for (size_t i = 40; i < others[0].size(); i += 97)
+        others[0][i] = others[0][i] == 'A' ? 'G' : 'A';
+    others[1].insert(500, "ACGTT");
+
+    vector<byte> data1 = dna::ConvertToData(s1);
+    array<dna::DNA_Stream, 23> chroms1;
+    for (auto& chrom : chroms1)
+        chrom = dna::DNA_Stream(data1, 16);
+    dna::Person person(chroms1);
+
+    vector<vector<byte>> data;
+    vector<dna::Person> cohort;
+    for (const auto& other : others)
+        data.push_back(dna::ConvertToData(other));
+    for (const auto& bytes : data)
+    {
+        array<dna::DNA_Stream, 23> chroms;
+        for (auto& chrom : chroms)
+            chrom = dna::DNA_Stream(bytes, 12);
+        cohort.emplace_back(chroms);
+    }
+
+    dna::Work_Stealing_Pool pool(2);
+    auto expected = person.CompareAgainst(cohort, pool);
+
+    auto requireResumed = [&](const vector<vector<dna::Chromosome_Comparison>>& partial) {
+        for (size_t j = 0; j < cohort.size(); j++)
+        {
+            auto resumed = person.Resume(cohort[j], partial[j], pool);
+            REQUIRE(resumed.size() == expected[j].size());
+            for (size_t i = 0; i < resumed.size(); i++)
+            {
+                REQUIRE(resumed[i].complete);
+                REQUIRE(resumed[i].transformations.size() == expected[j][i].transformations.size());
+                for (size_t k = 0; k < resumed[i].transformations.size(); k++)
+                {
+                    REQUIRE(resumed[i].transformations[k].index == expected[j][i].transformations[k].index);
+                    REQUIRE(resumed[i].transformations[k].s1 == expected[j][i].transformations[k].s1);
+                    REQUIRE(resumed[i].transformations[k].s2 == expected[j][i].transformations[k].s2);
+                }
+            }
+        }
+    };
+
+    SECTION("progress is counted for every chromosome")
+    {
+        dna::Comparison_Progress progress(23);
+        dna::Comparison_Options options;
+        options.progress = &progress;
+        person.CompareAgainst(cohort, pool, options);
+        for (const auto& snapshot : progress.snapshot())
+        {
+            REQUIRE(snapshot.finished);
+            REQUIRE(snapshot.chunks > 0);
+            REQUIRE(snapshot.c1Bases >= s1.size());
+        }
+    }
+
+    SECTION("cancelled comparisons resume")
+    {
+        dna::Cancellation_Token token;
+        dna::Comparison_Options options;
+        options.cancellation = &token;
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            token.cancel();
+        });
+        auto partial = person.CompareAgainst(cohort, pool, options);
+        canceller.join();
+        requireResumed(partial);
+
+        auto none = person.CompareAgainst(cohort, pool, options);
+        for (const auto& comparisons : none)
+            for (const auto& comparison : comparisons)
+                REQUIRE_FALSE(comparison.complete);
+        requireResumed(none);
+    }
+
+    SECTION("comparisons that don't fit in memory stop and resume")
+    {
+        dna::Memory_Budget memory(1 << 20, dna::Memory_Budget::Policy::fail);
+        dna::Comparison_Options options;
+        options.memory = &memory;
+        auto held = memory.reserve(memory.capacity());
+        auto partial = person.CompareAgainst(cohort, pool, options);
+        held.release();
+        for (const auto& comparisons : partial)
+            for (const auto& comparison : comparisons)
+            {
+                REQUIRE_FALSE(comparison.complete);
+                REQUIRE(comparison.resumeFrom == 0);
+            }
+        requireResumed(partial);
+        REQUIRE(memory.used() == 0);
+    }
+}
+
+TEST_CASE("People can be screened chromosome by chromosome", "[person]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string s2 = "GGGTTAGGGTTAGGGTTAGGGTAACGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 4);
+        chroms2[i] = dna::DNA_Stream(i == 5 ? data1 : data2, 4);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Work_Stealing_Pool pool(2);
+    vector<dna::Chromosome_Similarity> similarities = person1.Similarity(person2, pool);
+    REQUIRE(similarities.size() == 23);
+    for (size_t i = 0; i < similarities.size(); i++)
+    {
+        REQUIRE(similarities[i].chromosome == static_cast<int>(i));
+        REQUIRE(similarities[i].bases == data1.size() * dna::packed_size::value - 21);
+        REQUIRE(similarities[i].mismatches == (i == 5 ? 0 : 1));
+    }
+}
+
+TEST_CASE("Screening skips the leading telomeres", "[person]")
+{
+    // One and two whole leading telomeres, so that the bodies start in different phases.
+    string body = "TAGCGAATATATTTACGGATCCAGTTAGGGTTAGGGTTAGGG";
+    string s1 = "GGGTTAGGG" + body;
+    string s2 = "GGGTTAGGGTTAGGG" + body;
+    vector<byte> data1 = dna::ConvertToData(s1);
+    vector<byte> data2 = dna::ConvertToData(s2);
+
+    array<dna::DNA_Stream, 23> chroms1;
+    array<dna::DNA_Stream, 23> chroms2;
+    for (size_t i = 0; i < 23; i++)
+    {
+        chroms1[i] = dna::DNA_Stream(data1, 3);
+        chroms2[i] = dna::DNA_Stream(data2, 3);
+    }
+    dna::Person person1(chroms1);
+    dna::Person person2(chroms2);
+
+    dna::Work_Stealing_Pool pool(2);
+    for (const auto& similarity : person1.Similarity(person2, pool))
+    {
+        REQUIRE(similarity.bases == body.size() + 1);     // and a padding 'A' both have
+        REQUIRE(similarity.mismatches == 0);
+        REQUIRE(similarity.score == 1.0);
+    }
+}
@@ -0,0 +1,117 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Chromosome_Comparer.hpp"
+#include "Reverse_Complement.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static string ReverseComplementText(const string& text)
+{
+    string result;
+    for (auto it = text.rbegin(); it != text.rend(); ++it)
+        result += dna::to_char(dna::complement(dna::to_base(*it)));
+    return result;
+}
+
+static string Bases(size_t length)
+{
+    string text;
+    for (size_t i = 0; i < length; i++)
+        text += "ACGT"[(i * 7 + i / 3) % 4];
+    return text;
+}
+
+TEST_CASE("Bases complement their partners", "[revcomp]")
+{
+    REQUIRE(dna::complement(dna::A) == dna::T);
+    REQUIRE(dna::complement(dna::C) == dna::G);
+    REQUIRE(dna::complement(dna::G) == dna::C);
+    REQUIRE(dna::complement(dna::T) == dna::A);
+    REQUIRE(dna::complement_packed(dna::pack(dna::A, dna::C, dna::G, dna::T)) == dna::pack(dna::T, dna::G, dna::C, dna::A));
+    REQUIRE(dna::reverse_complement_packed(dna::pack(dna::A, dna::A, dna::C, dna::G)) == dna::pack(dna::C, dna::G, dna::T, dna::T));
+}
+
+TEST_CASE("Packed reverse complements match reversing the text", "[revcomp]")
+{
+    for (size_t length : { 0, 1, 2, 3, 4, 5, 31, 32, 33, 35, 64, 101, 250 })
+    {
+        INFO("length " << length);
+        string text = Bases(length);
+        vector<byte> packed = dna::ConvertToData(text);
+
+        vector<byte> reversed = dna::ReverseComplement(byte_view(packed.data(), packed.size()), length);
+        REQUIRE(reversed == dna::ConvertToData(ReverseComplementText(text)));
+    }
+}
+
+TEST_CASE("Reverse complement streams read the opposite strand", "[revcomp]")
+{
+    string text = Bases(203);
+    vector<byte> packed = dna::ConvertToData(text);
+    vector<byte> expected = dna::ConvertToData(ReverseComplementText(text));
+    dna::DNA_Stream forward(packed, 7);
+
+    // One padding base in the last byte.
+    dna::Reverse_Complement_Stream stream(forward, 1);
+    REQUIRE(stream.size() == expected.size());
+
+    vector<byte> read;
+    while (!stream.atEnd())
+    {
+        auto chunk = stream.read();
+        read.insert(read.end(), chunk.buffer().begin(), chunk.buffer().end());
+    }
+    REQUIRE(read == expected);
+
+    stream.seek(10);
+    auto chunk = stream.read(3);
+    REQUIRE(vector<byte>(chunk.buffer().begin(), chunk.buffer().end()) == vector<byte>(expected.begin() + 10, expected.begin() + 13));
+
+    dna::DNA_Stream opposite = dna::ReverseComplement(forward, 1);
+    auto all = opposite.view(0, opposite.size());
+    REQUIRE(vector<byte>(all.buffer().begin(), all.buffer().end()) == expected);
+}
+
+TEST_CASE("Chromosomes can be compared against the opposite strand", "[revcomp]")
+{
+    string s1 = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGGTTAGGG";
+    string whole = "GGGTTAGGGTTAGGGTTAGGGTAACGACTGTATTAGGGTTAGGGTTAGGGTTAGGG";
+
+    // Whatever padding the sample's last byte needs.
+    for (size_t removed = 0; removed < dna::packed_size::value; removed++)
+    {
+        string s2 = whole;
+        s2.erase(26, removed);
+        size_t padding = (dna::packed_size::value - s2.size() % dna::packed_size::value) % dna::packed_size::value;
+        INFO("padding " << padding);
+
+        vector<byte> data1 = dna::ConvertToData(s1);
+        vector<byte> data2 = dna::ConvertToData(s2);
+        vector<byte> reversed2 = dna::ConvertToData(ReverseComplementText(s2));
+        dna::DNA_Stream stream1(data1, 2);
+        dna::DNA_Stream stream2(data2, 2);
+        dna::DNA_Stream opposite2(reversed2, 2);
+
+        dna::Chromosome_Comparison expected = dna::Chromosome_Comparer(0, stream1, stream2).Compare();
+
+        // A sample read from the other strand lines up once it is turned around.
+        dna::Comparison_Options options;
+        options.oppositeStrand = true;
+        options.oppositePadding = padding;
+        dna::Chromosome_Comparison comparison = dna::Chromosome_Comparer(0, stream1, opposite2, options).Compare();
+
+        REQUIRE(comparison.transformations.size() == expected.transformations.size());
+        for (size_t i = 0; i < expected.transformations.size(); i++)
+        {
+            REQUIRE(comparison.transformations[i].index == expected.transformations[i].index);
+            REQUIRE(comparison.transformations[i].s1 == expected.transformations[i].s1);
+            REQUIRE(comparison.transformations[i].s2 == expected.transformations[i].s2);
+        }
+    }
+}
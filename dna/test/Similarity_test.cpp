@@ -0,0 +1,90 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "Similarity.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using std::byte;
+using std::string;
+using std::vector;
+
+static string Bases(size_t length, size_t seed)
+{
+    string text;
+    for (size_t i = 0; i < length; i++)
+        text += "ACGT"[(i * 7 + i / 3 + seed * (i % 5 == 0)) % 4];
+    return text;
+}
+
+static size_t CountSlowly(const string& a, const string& b)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); i++)
+        count += a[i] != b[i];
+    return count;
+}
+
+TEST_CASE("Mismatch counts match counting base by base", "[similarity]")
+{
+    // Long enough for every kernel's blocks, and with tails of every length after them.
+    for (size_t length : { 0, 1, 3, 4, 31, 128, 130, 256, 1001, 4099 })
+    {
+        INFO("length " << length);
+        string a = Bases(length, 0);
+        string b = Bases(length, 1);
+        vector<byte> packedA = dna::ConvertToData(a);
+        vector<byte> packedB = dna::ConvertToData(b);
+
+        dna::sequence_buffer<byte_view> bufA(byte_view(packedA.data(), packedA.size()), length);
+        dna::sequence_buffer<byte_view> bufB(byte_view(packedB.data(), packedB.size()), length);
+        if (length > 0)
+            REQUIRE(dna::CountMismatches(bufA, bufB) == CountSlowly(a, b));
+        REQUIRE(dna::CountMismatches(packedA.data(), packedA.data(), packedA.size()) == 0);
+    }
+}
+
+TEST_CASE("Screening counts the bases one sequence lacks as mismatches", "[similarity]")
+{
+    string a = "ACGTACGTAC";
+    string b = "ACGAACGT";
+    vector<byte> packedA = dna::ConvertToData(a);
+    vector<byte> packedB = dna::ConvertToData(b);
+    dna::sequence_buffer<byte_view> bufA(byte_view(packedA.data(), packedA.size()), a.size());
+    dna::sequence_buffer<byte_view> bufB(byte_view(packedB.data(), packedB.size()), b.size());
+
+    dna::Chromosome_Similarity similarity = dna::ScreenChromosome(4, bufA, bufB);
+    REQUIRE(similarity.chromosome == 4);
+    REQUIRE(similarity.bases == 10);
+    REQUIRE(similarity.mismatches == 3);
+    REQUIRE(similarity.score == Approx(0.7));
+    REQUIRE(dna::Similarity(bufA, bufA) == 1.0);
+}
+
+TEST_CASE("Sequences of different lengths can't be counted against each other", "[similarity]")
+{
+    vector<byte> packed = dna::ConvertToData("ACGTACGT");
+    dna::sequence_buffer<byte_view> a(byte_view(packed.data(), packed.size()), 8);
+    dna::sequence_buffer<byte_view> b(byte_view(packed.data(), packed.size()), 7);
+    REQUIRE_THROWS_AS(dna::CountMismatches(a, b), std::invalid_argument);
+}
+
+TEST_CASE("Mismatches are counted between sequences out of phase", "[similarity]")
+{
+    string a = Bases(300, 0);
+    string b = Bases(303, 1);
+    vector<byte> packedA = dna::ConvertToData(a);
+    vector<byte> packedB = dna::ConvertToData(b);
+    dna::sequence_buffer<byte_view> bufA(byte_view(packedA.data(), packedA.size()), a.size());
+    dna::sequence_buffer<byte_view> bufB(byte_view(packedB.data(), packedB.size()), b.size());
+
+    for (size_t shift : { 0, 1, 2, 3 })
+    {
+        INFO("shift " << shift);
+        REQUIRE(dna::CountMismatches(bufA.subsequence(4, 250), bufB.subsequence(4 + shift, 250)) ==
+                CountSlowly(a.substr(4, 250), b.substr(4 + shift, 250)));
+    }
+}
+
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <string>
+#include <utility>
 #include "String_Comparer.hpp"
 
 using std::string;
@@ -259,3 +260,29 @@ TEST_CASE("Second string contains the first string", "[strings]")
     string transformedS1 = dna::applyTransformations(s1, transformations);
     REQUIRE(transformedS1 == s2);
 }
+
+TEST_CASE("Differences in the first characters", "[strings]")
+{
+    vector<std::pair<string, string>> cases = {
+        { "CTAGGGAGGCAAAAGC", "CCGGGAGACAAAAGC" },
+        { "GCATT", "TCGTCCACACAC" },
+        { "CTCAGCTAAGCT", "GG" },
+        { "A", "GCA" },
+        { "TACG", "ACG" },
+    };
+
+    dna::String_Comparer comparer;
+    for (const auto& [s1, s2] : cases)
+    {
+        vector<dna::Transformation> transformations = comparer.Compare(s1, s2);
+
+        // Each one starts past where the one before it ended.
+        size_t end = 0;
+        for (const auto& t : transformations)
+        {
+            REQUIRE(t.index >= end);
+            end = t.index + (t.type == dna::DELETION ? 0 : t.s1.size());
+        }
+        REQUIRE(dna::applyTransformations(s1, transformations) == s2);
+    }
+}
@@ -0,0 +1,196 @@
+#include "catch.hpp"
+#include "base.hpp"
+#include "String_Comparer.hpp"
+#include "Variant_Set.hpp"
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using std::array;
+using std::byte;
+using std::vector;
+
+static dna::Variant_Set Align(const string& reference, const string& person)
+{
+    dna::Chromosome_Comparison comparison;
+    comparison.transformations = dna::String_Comparer().Compare(reference, person);
+    return dna::Variant_Set::FromComparison(comparison);
+}
+
+TEST_CASE("Variant sets are in reference positions", "[variants]")
+{
+    string reference = "ACGTACGTACGTACGT";
+    string person    = "ACGTTTACGTAGTACGA";
+
+    dna::Variant_Set set = Align(reference, person);
+    for (size_t i = 1; i < set.variants.size(); i++)
+        REQUIRE(set.variants[i - 1].position <= set.variants[i].position);
+    for (const auto& v : set.variants)
+        REQUIRE(reference.compare(v.position, v.ref.size(), v.ref) == 0);
+
+    REQUIRE(dna::applyTransformations(reference, set.toComparison().transformations) == person);
+
+    // The same from a comparison that was kept packed.
+    dna::Chromosome_Comparison comparison;
+    comparison.transformations = dna::String_Comparer().Compare(reference, person);
+    comparison.pack();
+    dna::Variant_Set packed = dna::Variant_Set::FromComparison(comparison);
+    REQUIRE(packed.variants.size() == set.variants.size());
+    for (size_t i = 0; i < set.variants.size(); i++)
+    {
+        REQUIRE(packed.variants[i].position == set.variants[i].position);
+        REQUIRE(packed.variants[i].type == set.variants[i].type);
+        REQUIRE(packed.variants[i].ref == set.variants[i].ref);
+        REQUIRE(packed.variants[i].alt == set.variants[i].alt);
+    }
+}
+
+TEST_CASE("Pairwise comparisons come from merging variant sets", "[variants]")
+{
+    string reference = "ACGTACGTACGTACGTACGTACGT";
+    vector<string> people = {
+        "ACGTACGTACGTACGTACGTACGT",         // the reference itself
+        "ACGTACCTACGTACGTACGTACGT",         // one substitution
+        "ACGTACCTACGTACGTAGGTACGT",         // the same one, and another
+        "ACGTACGTTTTACGTACGTACGT",          // an insertion and a deletion
+        "ACGACGTACGTACGTCGTACGTAA",         // deletions and an insertion at the end
+        "GCGTACCTAACGTACGTACGT",            // changes at the start
+    };
+
+    vector<dna::Variant_Set> sets;
+    for (const auto& person : people)
+    {
+        sets.push_back(Align(reference, person));
+        REQUIRE(dna::applyTransformations(reference, sets.back().toComparison().transformations) == person);
+    }
+
+    for (size_t i = 0; i < people.size(); i++)
+    {
+        for (size_t j = 0; j < people.size(); j++)
+        {
+            dna::Chromosome_Comparison comparison = dna::CompareVariants(sets[i], sets[j]);
+            REQUIRE(dna::applyTransformations(people[i], comparison.transformations) == people[j]);
+            if (i == j)
+                REQUIRE(comparison.transformations.empty());
+        }
+    }
+
+    // Shared variants cancel out.
+    dna::Chromosome_Comparison comparison = dna::CompareVariants(sets[1], sets[2]);
+    REQUIRE(comparison.transformations.size() == 1);
+    REQUIRE(comparison.transformations[0].type == dna::SUBSTITUTION);
+    REQUIRE(comparison.transformations[0].index == 17);
+}
+
+TEST_CASE("People are aligned to a reference once per chromosome", "[variants]")
+{
+    string reference = "GGGTTAGGGTTAGGGTTAGGGTAGCGAATATATTTAGGGTTAGGGTTAGGG";
+    string person    = "GGGTTAGGGTTAGGGTTAGGGTAACGACTATATTTAGGGTTAGGGTTAGGG";
+    vector<byte> referenceData = dna::ConvertToData(reference);
+    vector<byte> personData = dna::ConvertToData(person);
+
+    array<dna::DNA_Stream, 23> referenceChroms;
+    array<dna::DNA_Stream, 23> personChroms;
+    for (size_t i = 0; i < 23; i++)
+    {
+        referenceChroms[i] = dna::DNA_Stream(referenceData, 4);
+        personChroms[i] = dna::DNA_Stream(personData, 4);
+    }
+    dna::Person referencePerson(referenceChroms);
+    dna::Person somebody(personChroms);
+
+    dna::Work_Stealing_Pool pool(2);
+    vector<dna::Variant_Set> sets = dna::AlignToReference(referencePerson, somebody, pool);
+    REQUIRE(sets.size() == 23);
+    for (int i = 0; i < 23; i++)
+    {
+        REQUIRE(sets[i].chromosome == i);
+        REQUIRE(sets[i].variants.size() == 2);
+    }
+
+    vector<dna::Variant_Set> self = dna::AlignToReference(referencePerson, referencePerson, pool);
+    for (const auto& comparison : dna::CompareVariants(self, sets))
+    {
+        dna::Chromosome_Comparison direct = referencePerson.Compare(somebody, pool)[comparison.chromosome];
+        REQUIRE(comparison.transformations.size() == direct.transformations.size());
+        REQUIRE(dna::applyTransformations(reference, comparison.transformations) ==
+                dna::applyTransformations(reference, direct.transformations));
+    }
+}
+
+TEST_CASE("Comparing variant sets is comparing the people", "[variants]")
+{
+    // Different numbers of leading telomeres, and substitutions and indels spread over
+    // several chunks.
+    string body = "ACGATCGGATCCATGCAAGTCCGATGCATCGATCGTACGGCATCGACTGACGTACGATGCCATG";
+    string trailing = "TTAGGGTTAGGGTTAGGG";
+    string referenceLeading = "GGGTTAGGGTTAGGGTTAGGG";
+    string leadingA = "GGGTTAGGG";
+    string leadingB = "GGGTTAGGGTTAGGGTTAGGGTTAGGGTTAGGG";
+    string bodyA = body.substr(0, 10) + "T" + body.substr(11, 19) + "GG" + body.substr(30);
+    string bodyB = body.substr(0, 24) + body.substr(28, 20) + "C" + body.substr(49) + "AAGT";
+
+    vector<string> genomes = { referenceLeading + body + trailing, leadingA + bodyA + trailing, leadingB + bodyB + trailing };
+    vector<vector<byte>> data;
+    vector<dna::Person> people;
+    for (const auto& genome : genomes)
+    {
+        data.push_back(dna::ConvertToData(genome));
+        array<dna::DNA_Stream, 23> chroms;
+        for (auto& chrom : chroms)
+            chrom = dna::DNA_Stream(data.back(), 4);
+        people.emplace_back(chroms);
+    }
+
+    dna::Work_Stealing_Pool pool(2);
+    vector<dna::Variant_Set> setsA = dna::AlignToReference(people[0], people[1], pool);
+    vector<dna::Variant_Set> setsB = dna::AlignToReference(people[0], people[2], pool);
+    vector<dna::Chromosome_Comparison> direct = people[1].Compare(people[2], pool);
+    vector<dna::Chromosome_Comparison> fromSets = dna::CompareVariants(setsA, setsB);
+    REQUIRE(fromSets.size() == direct.size());
+    for (size_t c = 0; c < direct.size(); c++)
+    {
+        // Each keeps A's leading telomeres, and otherwise reads like B.
+        string expected = leadingA + bodyB + trailing;
+        REQUIRE(dna::applyTransformations(genomes[1], direct[c].transformations) == expected);
+        REQUIRE(dna::applyTransformations(genomes[1], fromSets[c].transformations) == expected);
+        REQUIRE(fromSets[c].c1Start == direct[c].c1Start);
+        REQUIRE(fromSets[c].c2Start == direct[c].c2Start);
+    }
+}
+
+TEST_CASE("Variant sets out of order can't be compared", "[variants]")
+{
+    dna::Variant_Set a;
+    a.variants.push_back({ 8, dna::SUBSTITUTION, "A", "C" });
+    a.variants.push_back({ 4, dna::SUBSTITUTION, "G", "T" });
+    dna::Variant_Set b;
+    REQUIRE_THROWS_AS(dna::CompareVariants(a, b), std::invalid_argument);
+    REQUIRE_THROWS_AS(dna::CompareVariants(b, a), std::invalid_argument);
+
+    // Nor can ones whose variants overlap.
+    a.variants = { { 4, dna::DELETION, "GTA", "" }, { 5, dna::SUBSTITUTION, "T", "C" } };
+    REQUIRE_THROWS_AS(dna::CompareVariants(a, b), std::invalid_argument);
+}
+
+TEST_CASE("Variant sets are compared by chromosome", "[variants]")
+{
+    // As when the reference is of the other sex: neither set has the sex chromosome.
+    vector<dna::Variant_Set> a(3);
+    vector<dna::Variant_Set> b(2);
+    for (int i = 0; i < 3; i++)
+        a[i].chromosome = i;
+    b[0].chromosome = 0;
+    b[1].chromosome = 2;
+    b[1].variants.push_back({ 3, dna::INSERTION, "", "TT" });
+
+    vector<dna::Chromosome_Comparison> comparisons = dna::CompareVariants(a, b);
+    REQUIRE(comparisons.size() == 2);
+    REQUIRE(comparisons[0].chromosome == 0);
+    REQUIRE(comparisons[0].transformations.empty());
+    REQUIRE(comparisons[1].chromosome == 2);
+    REQUIRE(comparisons[1].transformations.size() == 1);
+    REQUIRE(comparisons[1].transformations[0].index == 3);
+}
@@ -0,0 +1,69 @@
+#include "catch.hpp"
+#include "Work_Stealing_Pool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using std::vector;
+
+TEST_CASE("Task groups wait for all of their tasks", "[pool]")
+{
+    dna::Work_Stealing_Pool pool(4);
+    REQUIRE(pool.workers() == 4);
+
+    std::atomic<long> sum{0};
+    dna::Task_Group group(pool);
+    for (long i = 1; i <= 1000; i++)
+        group.run([&sum, i] { sum += i; });
+    group.wait();
+
+    REQUIRE(sum == 500500);
+}
+
+TEST_CASE("Tasks can spawn more tasks into their group", "[pool]")
+{
+    dna::Work_Stealing_Pool pool(3);
+    vector<std::atomic<int>> visited(64);
+
+    dna::Task_Group group(pool);
+    std::function<void(int, int)> split = [&](int begin, int end) {
+        if (end - begin == 1)
+        {
+            visited[begin]++;
+            return;
+        }
+        int middle = (begin + end) / 2;
+        group.run([&, begin, middle] { split(begin, middle); });
+        group.run([&, middle, end] { split(middle, end); });
+    };
+    group.run([&] { split(0, 64); });
+    group.wait();
+
+    for (auto& v : visited)
+        REQUIRE(v == 1);
+}
+
+TEST_CASE("Exceptions from tasks reach the waiting thread", "[pool]")
+{
+    dna::Work_Stealing_Pool pool(2);
+    std::atomic<int> completed{0};
+
+    dna::Task_Group group(pool);
+    for (int i = 0; i < 10; i++)
+    {
+        group.run([&, i] {
+            if (i == 5)
+                throw std::runtime_error("task failed");
+            completed++;
+        });
+    }
+
+    REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+    REQUIRE(completed == 9);
+
+    // The group can be used again once the error has been reported.
+    group.run([&] { completed++; });
+    group.wait();
+    REQUIRE(completed == 10);
+}
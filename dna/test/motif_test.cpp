@@ -0,0 +1,97 @@
+#include "catch.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "motif.hpp"
+#include "byte_view.hpp"
+
+using telomere = dna::motif<"TTAGGG">;
+
+// Everything about a motif is known to the compiler.
+static_assert(telomere::size == 6);
+static_assert(telomere::pattern == 0xF2A0000000000000ull);
+static_assert(telomere::mask == 0xFFF0000000000000ull);
+static_assert(telomere::phase_patterns[1] == telomere::pattern >> 2);
+static_assert(telomere::phase_masks[3] == telomere::mask >> 6);
+static_assert(telomere::leading_fragments[0] == "TAGGG" && telomere::leading_fragments[4] == "G");
+static_assert(telomere::trailing_fragments[0] == "TTAGG" && telomere::trailing_fragments[4] == "T");
+static_assert(telomere::repeats == 5);
+static_assert(telomere::starts(telomere::pattern | 0x1234));
+static_assert(telomere::matches(telomere::pattern >> 10) == 1u << 5);
+static_assert(telomere::copies(telomere::repeated_pattern) == 5);
+static_assert(telomere::copies(telomere::pattern) == 1);
+
+namespace
+{
+	std::size_t FindSlowly(const std::string& text, std::string_view motif, std::size_t pos = 0)
+	{
+		auto found = text.find(motif, pos);
+		return found == std::string::npos ? telomere::npos : found;
+	}
+
+	std::size_t CountSlowly(const std::string& text, std::string_view motif)
+	{
+		std::size_t result = 0;
+		for (auto found = text.find(motif); found != std::string::npos; found = text.find(motif, found + 1))
+			result++;
+		return result;
+	}
+}
+
+TEST_CASE("A motif is found wherever it starts in the packed bases", "[motif]")
+{
+	std::string text;
+	for (int i = 0; i < 200; i++)
+		text += "ACGT"[(i * 7 + i / 3) % 4];
+	for (std::size_t at : { 0, 1, 2, 3, 30, 31, 57, 100, 194 })
+		text.replace(at, telomere::size, telomere::text);
+
+	std::vector<std::byte> data = dna::ConvertToData(text);
+	dna::sequence_buffer buf(byte_view(data.data(), data.size()), text.size());
+
+	REQUIRE(telomere::count(buf) == CountSlowly(text, telomere::text));
+	for (std::size_t pos = 0; pos <= text.size(); pos++)
+	{
+		INFO("pos " << pos);
+		REQUIRE(telomere::find(buf, pos) == FindSlowly(text, telomere::text, pos));
+	}
+
+	// Out of phase views and ones that cut a copy short.
+	for (std::size_t pos : { 1, 2, 3, 5 })
+	{
+		auto sub = buf.subsequence(pos, 198 - pos);
+		std::string expected = text.substr(pos, 198 - pos);
+		REQUIRE(telomere::find(sub) == FindSlowly(expected, telomere::text));
+		REQUIRE(telomere::count(sub) == CountSlowly(expected, telomere::text));
+	}
+}
+
+TEST_CASE("A motif's padding doesn't match past the end", "[motif]")
+{
+	using adenines = dna::motif<"AAAA">;
+	std::vector<std::byte> data = dna::ConvertToData("CCCAAA");
+	dna::sequence_buffer buf(byte_view(data.data(), data.size()), 6);
+
+	REQUIRE(adenines::find(buf) == adenines::npos);
+	REQUIRE(adenines::count(buf) == 0);
+	REQUIRE(adenines::run(buf, 3) == 0);
+}
+
+TEST_CASE("A run of a motif is measured a word at a time", "[motif]")
+{
+	for (std::size_t copies : { 0, 1, 4, 5, 6, 11, 40 })
+	{
+		INFO("copies " << copies);
+		std::string text;
+		for (std::size_t i = 0; i < copies; i++)
+			text += telomere::text;
+		std::string withTail = "G" + text + "TTAGGCAT";
+
+		std::vector<std::byte> data = dna::ConvertToData(withTail);
+		dna::sequence_buffer buf(byte_view(data.data(), data.size()), withTail.size());
+		REQUIRE(telomere::run(buf, 1) == copies);
+		REQUIRE(telomere::run(buf.subsequence(1)) == copies);
+		REQUIRE(telomere::run(buf.subsequence(0, 1 + copies * telomere::size)) == 0);
+		REQUIRE(telomere::run(buf.subsequence(1, copies * telomere::size)) == copies);
+	}
+}
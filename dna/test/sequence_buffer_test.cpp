@@ -1,6 +1,13 @@
 #include "catch.hpp"
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <vector>
 #include "sequence_buffer.hpp"
+#include "byte_view.hpp"
 
 TEST_CASE("Can use a Sequence Buffer", "[seqbuf]")
 {
@@ -44,3 +51,138 @@ TEST_CASE("Can use an iterator", "[seqbuf]")
 	REQUIRE(bases[7] == dna::C);
 
 }
+
+TEST_CASE("Can read 32 bases at a time at any offset", "[seqbuf]")
+{
+	std::string sequence;
+	for (int i = 0; i < 101; i++)
+		sequence += "ACGT"[(i * 7 + i / 3) % 4];
+	std::vector<std::byte> data = dna::ConvertToData(sequence);
+
+	// Both the byte-by-byte path and, through the view, the eight-bytes-at-once one.
+	dna::sequence_buffer buf(data, sequence.size());
+	dna::sequence_buffer view(byte_view(data.data(), data.size()), sequence.size());
+
+	for (std::size_t index = 0; index < sequence.size(); index++)
+	{
+		std::uint64_t expected = 0;
+		for (std::size_t i = 0; i < 32; i++)
+		{
+			auto value = index + i < sequence.size() ? static_cast<std::uint64_t>(dna::to_base(sequence[index + i])) : 0;
+			expected = (expected << 2) | value;
+		}
+
+		INFO("index " << index);
+		REQUIRE(buf.word(index) == expected);
+		REQUIRE(view.word(index) == expected);
+	}
+	REQUIRE(buf.word(sequence.size()) == 0);
+}
+
+TEST_CASE("Words leave out the padding of the last byte", "[seqbuf]")
+{
+	std::array<std::byte, 2> data = {
+			dna::pack(dna::T, dna::T, dna::T, dna::T),
+			dna::pack(dna::T, dna::T, dna::T, dna::T),
+	};
+
+	dna::sequence_buffer buf(data, 5);
+	REQUIRE(buf.word(0) == 0xFFC0000000000000ull);
+	REQUIRE(buf.word(3) == 0xF000000000000000ull);
+
+	static_assert(dna::sequence_buffer(std::array<std::byte, 1>{ dna::pack(dna::C, dna::G, dna::T, dna::A) }).word(1) ==
+				  0xB000000000000000ull);
+}
+
+static_assert(std::random_access_iterator<dna::sequence_buffer<byte_view>::iterator>);
+static_assert(std::ranges::random_access_range<dna::sequence_buffer<byte_view>>);
+static_assert(std::ranges::sized_range<dna::sequence_buffer<byte_view>>);
+
+TEST_CASE("Can use the iterator with random-access algorithms", "[seqbuf]")
+{
+	std::vector<std::byte> data = dna::ConvertToData("AAAACCCGGGGGTT");
+	dna::sequence_buffer buf(data, 14);
+
+	REQUIRE(buf.end() - buf.begin() == 14);
+	REQUIRE(buf.begin()[7] == dna::G);
+	REQUIRE(*(2 + buf.begin()) == dna::A);
+	REQUIRE(buf.begin() < buf.end());
+	REQUIRE(std::lower_bound(buf.begin(), buf.end(), dna::G) - buf.begin() == 7);
+	REQUIRE(std::ranges::count(buf, dna::C) == 3);
+}
+
+TEST_CASE("Packed mismatch, equal and count agree with the base-by-base ones", "[seqbuf]")
+{
+	std::string s1;
+	for (int i = 0; i < 150; i++)
+		s1 += "ACGT"[(i * 5 + i / 7) % 4];
+
+	for (std::size_t change : { 0, 1, 31, 32, 33, 70, 149 })
+	{
+		std::string s2 = s1;
+		s2[change] = s2[change] == 'A' ? 'C' : 'A';
+
+		std::vector<std::byte> data1 = dna::ConvertToData(s1);
+		std::vector<std::byte> data2 = dna::ConvertToData("G" + s2);
+		dna::sequence_buffer buf1(byte_view(data1.data(), data1.size()), s1.size());
+		dna::sequence_buffer buf2(byte_view(data2.data(), data2.size()), s2.size() + 1);
+
+		// buf2 is one base out of phase with buf1.
+		for (std::size_t start : { 0, 1, 5, 40 })
+		{
+			INFO("change " << change << ", start " << start);
+			auto first1 = buf1.begin() + start;
+			auto first2 = buf2.begin() + start + 1;
+
+			auto found = dna::mismatch(first1, buf1.end(), first2);
+			auto expected = std::mismatch(first1, buf1.end(), first2);
+			REQUIRE(found.first == expected.first);
+			REQUIRE(found.second == expected.second);
+			REQUIRE(dna::equal(first1, buf1.end(), first2) == (change < start));
+		}
+	}
+
+	std::vector<std::byte> data = dna::ConvertToData(s1);
+	dna::sequence_buffer buf(data, s1.size());
+	REQUIRE(dna::equal(buf, buf));
+	for (dna::base b : { dna::A, dna::C, dna::G, dna::T })
+	{
+		REQUIRE(dna::count(buf, b) == std::count(s1.begin(), s1.end(), dna::to_char(b)));
+		REQUIRE(dna::count(buf.begin() + 3, buf.end() - 40, b) == std::count(s1.begin() + 3, s1.end() - 40, dna::to_char(b)));
+	}
+}
+
+TEST_CASE("Subsequences start at any base without repacking", "[seqbuf]")
+{
+	std::string sequence;
+	for (int i = 0; i < 90; i++)
+		sequence += "ACGT"[(i * 5 + i / 4) % 4];
+	std::vector<std::byte> data = dna::ConvertToData(sequence);
+	dna::sequence_buffer buf(byte_view(data.data(), data.size()), sequence.size());
+
+	for (std::size_t pos : { 0, 1, 2, 3, 4, 7, 45 })
+	{
+		INFO("pos " << pos);
+		auto sub = buf.subsequence(pos, 40);
+		REQUIRE(sub.size() == 40);
+		REQUIRE(sub.offset() == pos % 4);
+		REQUIRE(sub.buffer().data() == data.data() + pos / 4);
+
+		for (std::size_t i = 0; i < sub.size(); i++)
+			REQUIRE(dna::to_char(sub[i]) == sequence[pos + i]);
+		for (std::size_t i = 0; i < sub.size(); i++)
+			REQUIRE(sub.word(i) == buf.subsequence(pos + i, 40 - i).word(0));
+		REQUIRE(sub.word(8) == buf.word(pos + 8));
+
+		// Subsequences of subsequences keep to the original bases.
+		auto inner = sub.subsequence(3, 10);
+		for (std::size_t i = 0; i < inner.size(); i++)
+			REQUIRE(dna::to_char(inner[i]) == sequence[pos + 3 + i]);
+
+		REQUIRE(dna::equal(sub, dna::sequence_buffer(byte_view(data.data(), data.size()), pos, 40)));
+	}
+
+	REQUIRE(buf.subsequence(100).size() == 0);
+	REQUIRE(buf.subsequence(88).size() == 2);
+}
+